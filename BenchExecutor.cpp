@@ -0,0 +1,163 @@
+#include "BenchExecutor.hpp"
+
+namespace {
+
+// Index of the executor worker running on this thread, so jobs submitted
+// from inside a job land in the submitting worker's own deque
+thread_local const void* currentExecutor = nullptr;
+thread_local std::size_t currentWorker = 0;
+
+} // namespace
+
+bool BenchJobHandle::isDone() const {
+    if (!state_) {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(state_->mutex_);
+    return state_->done_;
+}
+
+void BenchJobHandle::wait() const {
+    if (!state_) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(state_->mutex_);
+    state_->finished_.wait(lock, [this] { return state_->done_; });
+}
+
+BenchExecutor::BenchExecutor(std::size_t threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency() != 0 ? std::thread::hardware_concurrency() : 2;
+    }
+    for (std::size_t i = 0; i < threadCount; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    // Start the threads only once every deque exists, since workers steal from each other
+    for (std::size_t i = 0; i < threadCount; ++i) {
+        workers_[i]->thread_ = std::thread(&BenchExecutor::workerLoop, this, i);
+    }
+}
+
+BenchExecutor::~BenchExecutor() {
+    shutdown();
+}
+
+BenchJobHandle BenchExecutor::submit(Job job) {
+    auto state = std::make_shared<BenchJobState>();
+    state->job = std::move(job);
+
+    const std::size_t target = currentExecutor == this ? currentWorker
+                                                      : nextWorker_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+    {
+        std::lock_guard<std::mutex> sleepLock(sleepMutex_);
+        if (stopping_) {
+            return BenchJobHandle();
+        }
+        std::lock_guard<std::mutex> lock(workers_[target]->mutex_);
+        workers_[target]->jobs_.push_back(state);
+        ++pending_;
+    }
+    wake_.notify_one();
+    return BenchJobHandle(std::move(state));
+}
+
+void BenchExecutor::shutdown() {
+    {
+        std::lock_guard<std::mutex> sleepLock(sleepMutex_);
+        if (stopping_) {
+            return;
+        }
+        stopping_ = true;
+    }
+    wake_.notify_all();
+
+    // Jobs not yet started are dropped; running jobs see their token cancelled
+    for (const std::unique_ptr<Worker>& worker : workers_) {
+        std::deque<std::shared_ptr<BenchJobState>> dropped;
+        {
+            std::lock_guard<std::mutex> lock(worker->mutex_);
+            dropped.swap(worker->jobs_);
+            if (worker->current_) {
+                worker->current_->cancellation.cancel();
+            }
+        }
+        for (const std::shared_ptr<BenchJobState>& job : dropped) {
+            job->cancellation.cancel();
+            finish(*job);
+        }
+    }
+    for (const std::unique_ptr<Worker>& worker : workers_) {
+        if (worker->thread_.joinable()) {
+            worker->thread_.join();
+        }
+    }
+}
+
+bool BenchExecutor::takeJob(std::size_t self, std::shared_ptr<BenchJobState>& job) {
+    {
+        Worker& own = *workers_[self];
+        std::lock_guard<std::mutex> lock(own.mutex_);
+        if (!own.jobs_.empty()) {
+            job = std::move(own.jobs_.back());
+            own.jobs_.pop_back();
+            own.current_ = job;
+            return true;
+        }
+    }
+    for (std::size_t offset = 1; offset < workers_.size(); ++offset) {
+        Worker& victim = *workers_[(self + offset) % workers_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex_);
+        if (!victim.jobs_.empty()) {
+            job = std::move(victim.jobs_.front());
+            victim.jobs_.pop_front();
+            break;
+        }
+    }
+    if (!job) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(workers_[self]->mutex_);
+    workers_[self]->current_ = job;
+    return true;
+}
+
+void BenchExecutor::workerLoop(std::size_t self) {
+    currentExecutor = this;
+    currentWorker = self;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> sleepLock(sleepMutex_);
+            wake_.wait(sleepLock, [this] { return pending_ != 0 || stopping_; });
+            if (stopping_) {
+                return;
+            }
+            --pending_;  // Claims one queued job; some deque is guaranteed to hold it
+        }
+
+        std::shared_ptr<BenchJobState> job;
+        while (!takeJob(self, job)) {
+            {
+                std::lock_guard<std::mutex> sleepLock(sleepMutex_);
+                if (stopping_) {
+                    return;  // shutdown() dropped the job
+                }
+            }
+            std::this_thread::yield();  // Raced with other workers over the deques; rescan
+        }
+        job->job(job->cancellation.token());
+        {
+            std::lock_guard<std::mutex> lock(workers_[self]->mutex_);
+            workers_[self]->current_.reset();
+        }
+        finish(*job);
+    }
+}
+
+void BenchExecutor::finish(BenchJobState& state) {
+    {
+        std::lock_guard<std::mutex> lock(state.mutex_);
+        state.done_ = true;
+        state.job = nullptr;  // Release captured resources early
+    }
+    state.finished_.notify_all();
+}
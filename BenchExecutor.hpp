@@ -0,0 +1,83 @@
+#ifndef BENCHEXECUTOR_HPP
+#define BENCHEXECUTOR_HPP
+
+#include "CancellationToken.hpp"
+#include <atomic>
+#include <cstddef>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Shared state of one submitted job
+struct BenchJobState {
+    std::function<void(const CancellationToken&)> job;
+    CancellationSource cancellation;
+    std::mutex mutex_;
+    std::condition_variable finished_;
+    bool done_ = false;
+};
+
+class BenchJobHandle {
+public:
+    BenchJobHandle() = default;
+    explicit BenchJobHandle(std::shared_ptr<BenchJobState> state) : state_(std::move(state)) {}
+
+    bool isValid() const { return state_ != nullptr; }
+    void cancel() { if (state_) state_->cancellation.cancel(); }
+    bool isDone() const;
+    void wait() const;  // Returns once the job ran or was discarded
+
+private:
+    std::shared_ptr<BenchJobState> state_;
+};
+
+// Fixed-size work-stealing thread pool for bench jobs.
+//
+// Each worker has its own deque: it takes its newest job first and, when
+// empty, steals the oldest job of another worker, so a burst of jobs from
+// one bench spreads over all cores without a shared queue bottleneck.
+// Jobs receive a cancellation token; shutdown() cancels every job, drops
+// the ones not yet started and joins the workers.
+class BenchExecutor {
+public:
+    using Job = std::function<void(const CancellationToken&)>;
+
+    explicit BenchExecutor(std::size_t threadCount = 0);  // 0: one worker per core
+    ~BenchExecutor();
+
+    BenchExecutor(const BenchExecutor&) = delete;
+    BenchExecutor& operator=(const BenchExecutor&) = delete;
+
+    // Returns an invalid handle after shutdown()
+    BenchJobHandle submit(Job job);
+
+    void shutdown();
+
+    std::size_t threadCount() const { return workers_.size(); }
+
+private:
+    struct Worker {
+        std::mutex mutex_;                                   // Guards jobs_ and current_
+        std::deque<std::shared_ptr<BenchJobState>> jobs_;
+        std::shared_ptr<BenchJobState> current_;             // Job being run, for shutdown()
+        std::thread thread_;
+    };
+
+    bool takeJob(std::size_t self, std::shared_ptr<BenchJobState>& job);
+    void workerLoop(std::size_t self);
+    static void finish(BenchJobState& state);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<std::size_t> nextWorker_{0};
+
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+    std::size_t pending_ = 0;   // Queued jobs, guarded by sleepMutex_
+    bool stopping_ = false;     // Guarded by sleepMutex_
+};
+
+#endif // BENCHEXECUTOR_HPP
@@ -0,0 +1,35 @@
+#ifndef CANCELLATIONTOKEN_HPP
+#define CANCELLATIONTOKEN_HPP
+
+#include <atomic>
+#include <memory>
+
+// Read side of a cancellation flag. Long-running work polls isCancelled()
+// at its safe points; a default-constructed token is never cancelled.
+class CancellationToken {
+public:
+    CancellationToken() = default;
+
+    bool isCancelled() const { return state_ != nullptr && state_->load(std::memory_order_acquire); }
+
+private:
+    friend class CancellationSource;
+    explicit CancellationToken(std::shared_ptr<const std::atomic<bool>> state) : state_(std::move(state)) {}
+
+    std::shared_ptr<const std::atomic<bool>> state_;
+};
+
+// Owner side: hands out tokens and cancels all of them at once
+class CancellationSource {
+public:
+    CancellationSource() : state_(std::make_shared<std::atomic<bool>>(false)) {}
+
+    void cancel() { state_->store(true, std::memory_order_release); }
+    bool isCancelled() const { return state_->load(std::memory_order_acquire); }
+    CancellationToken token() const { return CancellationToken(state_); }
+
+private:
+    std::shared_ptr<std::atomic<bool>> state_;
+};
+
+#endif // CANCELLATIONTOKEN_HPP
@@ -2,6 +2,10 @@
 #include "can_interface.hpp"
 #include "TestBenchOperations.hpp"
 #include "TestType.hpp"
+#include "dbc_cache.hpp"
+#include "bench_config.hpp"
+#include "dbc_schedule.hpp"
+#include "monotonic_clock.hpp"
 #include <QCoreApplication>
 #include <QDir>
 #include <QVBoxLayout>
@@ -10,18 +14,169 @@
 #include <QMessageBox>
 #include <QInputDialog>
 #include <QDockWidget>
+#include <QDialog>
+#include <QElapsedTimer>
+#include <QFileDialog>
+#include <QStatusBar>
+#include <QStringList>
+#include <QFileInfo>
+#include <QHeaderView>
+#include <QTreeWidget>
 #include <QProgressBar>
 #include <QLCDNumber>
 #include <QPushButton>
-
-MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent) {
+#include <algorithm>
+#include <iostream>
+
+MainWindow::MainWindow(QWidget *parent)
+    : QMainWindow(parent),
+      signalStore(BenchCount, CellsPerBench),
+      testOperations(BenchCount, CellsPerBench),
+      testEngine(signalStore, testOperations, benchExecutor),
+      cellTests(BenchCount * CellsPerBench, nullptr) {
     setupMenuBar();
     //setupToolBar();
     setupCentralWidget();
     setupRightPanel();
+    setupAcquisition();
+
+    // The GUI only reads the store, so polling never holds up acquisition
+    liveValueTimer = new QTimer(this);
+    connect(liveValueTimer, &QTimer::timeout, this, &MainWindow::refreshLiveValues);
+    liveValueTimer->start(LiveValueIntervalMs);
+
+    rxStatusLabel = new QLabel(this);
+    statusBar()->addPermanentWidget(rxStatusLabel);
+    rxTimeoutTimer = new QTimer(this);
+    connect(rxTimeoutTimer, &QTimer::timeout, this, &MainWindow::checkRxTimeouts);
+    rxTimeoutTimer->start(RxTimeoutCheckIntervalMs);
 }
 
-MainWindow::~MainWindow() {}
+MainWindow::~MainWindow() {
+    // The acquisition threads post to this window
+    for (const std::unique_ptr<BenchAcquisition>& acquisition : benchAcquisitions) {
+        acquisition->stop();
+    }
+}
+
+void MainWindow::setupAcquisition() {
+    const QString configPath = QDir::current().filePath("bench.cfg");
+    BenchConfig config;
+    std::string error;
+    if (!loadBenchConfig(QDir::toNativeSeparators(configPath).toStdString(), config, &error)) {
+        std::cerr << "Bench acquisition disabled! " << configPath.toStdString() << ": " << error << std::endl;
+        statusBar()->showMessage(QString("No live measurements: %1").arg(QString::fromStdString(error)));
+        return;
+    }
+    if (!loadDBCFileCached(config.dbcPath, benchDatabase, &error)) {
+        statusBar()->showMessage(QString("No live measurements: loading %1 failed: %2")
+                                     .arg(QString::fromStdString(config.dbcPath), QString::fromStdString(error)));
+        return;
+    }
+    signalDecoder = std::make_unique<SignalDecoder>(benchDatabase);
+    signalEncoder = std::make_unique<SignalEncoder>(benchDatabase);
+    channelManager = std::make_unique<CANChannelManager>(BenchCount);
+    transmitQueues.resize(BenchCount);
+    powerStages.resize(BenchCount);
+    rxTimeoutMonitors.resize(BenchCount);
+    if (!config.node.empty()) {
+        cyclicScheduler = std::make_unique<CyclicTransmitScheduler>();
+    }
+
+    struct AcquiredSignal {
+        std::size_t bench;
+        std::size_t cell;
+        CellSignal signal;
+    };
+    std::vector<AcquiredSignal> acquiredSignals;  // Handed to the test engine once acquisition runs
+    QStringList benchSummaries;
+    for (std::size_t bench = 0; bench < config.channels.size(); ++bench) {
+        const std::string& spec = config.channels[bench];
+        if (spec.empty()) {
+            continue;
+        }
+        std::unique_ptr<CANInterface> can = bench < static_cast<std::size_t>(BenchCount) ? openBenchChannel(spec) : nullptr;
+        const std::size_t channel = can ? channelManager->addChannel(std::move(can), bench) : CANChannelManager::InvalidChannel;
+        if (channel == CANChannelManager::InvalidChannel) {
+            benchSummaries << QString("Bench %1: %2 not opened").arg(bench + 1).arg(QString::fromStdString(spec));
+            continue;
+        }
+
+        auto acquisition = std::make_unique<BenchAcquisition>(*channelManager, bench, *signalDecoder, signalStore);
+        std::size_t mapped = 0;
+        for (std::size_t cell = 0; cell < static_cast<std::size_t>(CellsPerBench); ++cell) {
+            for (std::size_t signal = 0; signal < static_cast<std::size_t>(CellSignal::Count); ++signal) {
+                std::string messageName;
+                std::string signalName;
+                if (!expandSignalPattern(config.signalPatterns[signal], bench, cell, messageName, signalName)) {
+                    continue;
+                }
+                const std::uint32_t signalId = signalDecoder->findSignalId(messageName, signalName);
+                if (signalId != UINT32_MAX && acquisition->mapSignal(signalId, cell, static_cast<CellSignal>(signal))) {
+                    acquisition->setFilter(signalId, config.signalFilters[signal]);
+                    acquiredSignals.push_back(AcquiredSignal{bench, cell, static_cast<CellSignal>(signal)});
+                    ++mapped;
+                }
+            }
+        }
+        const std::size_t packedMessages = acquisition->enableCellFrameDecoding(benchDatabase);
+        // The store gets every sample; only the displayed cell's filtered
+        // changes cross over to the GUI thread
+        acquisition->setSampleListener([this, bench](std::size_t cell, CellSignal signal, double value, std::uint64_t) {
+            const int cellIndex = static_cast<int>(bench * CellsPerBench + cell);
+            if (cellIndex == liveCellIndex.load(std::memory_order_relaxed)) {
+                QMetaObject::invokeMethod(this, [this, cellIndex, signal, value]() { showLiveSample(cellIndex, signal, value); },
+                                          Qt::QueuedConnection);
+            }
+        });
+
+        // Cycle times come from GenMsgCycleTime: what node sends is
+        // scheduled, everything else cyclic is supervised
+        rxTimeoutMonitors[bench] = std::make_unique<RxTimeoutMonitor>(benchDatabase, config.node);
+        acquisition->setTimeoutMonitor(rxTimeoutMonitors[bench].get());
+        transmitQueues[bench] = std::make_unique<CANTransmitQueue>(channelManager->channel(channel));
+        powerStages[bench] = std::make_unique<PowerStageCommands>(*signalEncoder, *transmitQueues[bench], config, bench,
+                                                                  static_cast<std::size_t>(CellsPerBench));
+        const std::size_t sentMessages = cyclicScheduler
+            ? scheduleDBCMessages(*cyclicScheduler, *transmitQueues[bench], benchDatabase, *signalEncoder, config.node).size()
+            : 0;
+
+        benchSummaries << QString("Bench %1: %2 signals, %3 packed messages, %4 commanded cells, %5 cyclic sent, %6 supervised")
+                              .arg(bench + 1)
+                              .arg(mapped)
+                              .arg(packedMessages)
+                              .arg(powerStages[bench]->commandedCells())
+                              .arg(sentMessages)
+                              .arg(rxTimeoutMonitors[bench]->messageCount());
+        benchAcquisitions.push_back(std::move(acquisition));
+    }
+
+    if (benchAcquisitions.empty()) {
+        statusBar()->showMessage(QString("No live measurements: no bench channel opened (%1)").arg(benchSummaries.join(", ")));
+        return;
+    }
+    channelManager->start();
+    const std::uint64_t armUs = monotonicMicros();
+    for (const std::unique_ptr<RxTimeoutMonitor>& monitor : rxTimeoutMonitors) {
+        if (monitor) {
+            monitor->arm(armUs);
+        }
+    }
+    for (const std::unique_ptr<BenchAcquisition>& acquisition : benchAcquisitions) {
+        acquisition->start();
+    }
+    for (const AcquiredSignal& acquired : acquiredSignals) {
+        testEngine.setAcquired(acquired.bench, acquired.cell, acquired.signal);
+    }
+    // Setpoints and output off go to the bench's power stages from now on
+    testOperations.setCommandSink([this](std::size_t bench, std::size_t cell, const CellSetpoint& setpoint) {
+        if (!powerStages[bench] || !powerStages[bench]->send(cell, setpoint)) {
+            std::cerr << "Power stage command for bench " << bench + 1 << ", cell " << cell + 1
+                      << " not sent! No setpoint frame in bench.cfg" << std::endl;
+        }
+    });
+    statusBar()->showMessage(QString("Acquiring: %1").arg(benchSummaries.join(", ")));
+}
 
 void MainWindow::setupMenuBar() {
     // Menu Bar Setup
@@ -37,7 +192,10 @@ void MainWindow::setupMenuBar() {
     QMenu *viewMenu = menuBar()->addMenu("View");
     QAction *viewDBCMessageAction = new QAction("View DBC Messages", this);
     viewMenu->addAction(viewDBCMessageAction);
-    //connect(viewDBCMessageAction, &QAction::triggered, this, &MainWindow::onViewDBCMessage);
+    connect(viewDBCMessageAction, &QAction::triggered, this, &MainWindow::onViewDBCMessage);
+    QAction *selectLiveCellAction = new QAction("Live Cell...", this);
+    viewMenu->addAction(selectLiveCellAction);
+    connect(selectLiveCellAction, &QAction::triggered, this, &MainWindow::onSelectLiveCell);
 
     // Test Menu with Submenus for Test Benches and Options
     QMenu *testMenu = menuBar()->addMenu("Test");
@@ -85,18 +243,24 @@ void MainWindow::setupMenuBar() {
     QAction *aboutAction = new QAction("About", this);
     helpMenu->addAction(aboutAction);
 
-    // Add Start Test, Run, and Stop actions
+    // Add Start Test, Run, Pause, Resume and Stop actions
     QMenu *actionMenu = menuBar()->addMenu("Actions");
     QAction *startTestAction = new QAction("Start Test", this);
     QAction *runAction = new QAction("Run", this);
+    QAction *pauseAction = new QAction("Pause", this);
+    QAction *resumeAction = new QAction("Resume", this);
     QAction *stopAction = new QAction("Stop", this);
     
     actionMenu->addAction(startTestAction);
     actionMenu->addAction(runAction);
+    actionMenu->addAction(pauseAction);
+    actionMenu->addAction(resumeAction);
     actionMenu->addAction(stopAction);
 
     connect(startTestAction, &QAction::triggered, this, &MainWindow::onStartTestClicked);
     connect(runAction, &QAction::triggered, this, &MainWindow::onRunClicked);
+    connect(pauseAction, &QAction::triggered, this, &MainWindow::onPauseClicked);
+    connect(resumeAction, &QAction::triggered, this, &MainWindow::onResumeClicked);
     connect(stopAction, &QAction::triggered, this, &MainWindow::onStopClicked);
 }
 
@@ -111,15 +275,100 @@ void MainWindow::onRunClicked() {
     msgBox->exec();
 }
 
+TestBenchOperations* MainWindow::selectedTest() {
+    if (selectedBench < 0 || selectedCell < 0) {
+        return nullptr;
+    }
+    return cellTests[selectedBench * CellsPerBench + selectedCell];
+}
+
+// Stop, Pause and Resume act on the selected cell; the engine switches the
+// output off within one control period, and the result arrives through updateStatus
 void MainWindow::onStopClicked() {
-    // Implement what happens when Stop is clicked
-    // QMessageBox::information(this, "Stop Test", "Test has been stopped.");
-    auto msgBox = new QMessageBox();
-    msgBox->setMinimumSize(300, 300);
-    msgBox->setStyleSheet("QMessageBox{ background-color: black;}"
-                      "QPushButton{ background-color: white; color: black;}");
-    msgBox->setText("Stop action triggered.");
-    msgBox->exec();
+    TestBenchOperations* test = selectedTest();
+    if (test == nullptr) {
+        QMessageBox::information(this, "Stop Test", "No test is running on the selected cell.");
+        return;
+    }
+    test->stop();
+}
+
+void MainWindow::onPauseClicked() {
+    TestBenchOperations* test = selectedTest();
+    if (test == nullptr) {
+        QMessageBox::information(this, "Pause Test", "No test is running on the selected cell.");
+        return;
+    }
+    test->pause();
+}
+
+void MainWindow::onResumeClicked() {
+    TestBenchOperations* test = selectedTest();
+    if (test == nullptr) {
+        QMessageBox::information(this, "Resume Test", "No test is running on the selected cell.");
+        return;
+    }
+    test->resume();
+    updateStatus(QString("Resuming test on Test Bench: %1, Cell: %2").arg(selectedBench + 1).arg(selectedCell + 1));
+}
+
+void MainWindow::onViewDBCMessage() {
+    QString fileName = QFileDialog::getOpenFileName(this, "Open DBC File", QDir::current().filePath("dbc"),
+                                                    "DBC Files (*.dbc);;All Files (*)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    std::string error;
+    if (!loadDBCFileCached(QDir::toNativeSeparators(fileName).toStdString(), dbcDatabase, &error)) {
+        QMessageBox::warning(this, "DBC Error", QString("Loading %1 failed:\n%2").arg(fileName, QString::fromStdString(error)));
+        return;
+    }
+    const qint64 loadTimeMs = timer.elapsed();
+
+    // One top-level row per message, its signals as children
+    QDialog *dialog = new QDialog(this);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->setWindowTitle(QString("%1 - %2 messages, loaded in %3 ms")
+                               .arg(QFileInfo(fileName).fileName()).arg(dbcDatabase.messages.size()).arg(loadTimeMs));
+    dialog->resize(800, 500);
+
+    QTreeWidget *tree = new QTreeWidget(dialog);
+    tree->setHeaderLabels({"Name", "ID / Bits", "Length / Byte Order", "Factor", "Offset", "Range", "Unit", "Comment"});
+    for (const DBCMessage &message : dbcDatabase.messages) {
+        QTreeWidgetItem *messageItem = new QTreeWidgetItem(tree);
+        messageItem->setText(0, QString::fromStdString(message.name));
+        messageItem->setText(1, QString("0x%1%2").arg(message.id, 0, 16).arg(message.extended ? " (ext)" : ""));
+        messageItem->setText(2, QString("%1 bytes").arg(message.size));
+        messageItem->setText(7, QString::fromStdString(message.comment));
+
+        for (const DBCSignal &signal : message.signals) {
+            QString name = QString::fromStdString(signal.name);
+            if (signal.isMultiplexor) {
+                name += " [M]";
+            }
+            if (signal.isMultiplexed) {
+                name += QString(" [m%1]").arg(signal.multiplexValue);
+            }
+            QTreeWidgetItem *signalItem = new QTreeWidgetItem(messageItem);
+            signalItem->setText(0, name);
+            signalItem->setText(1, QString("%1|%2").arg(signal.startBit).arg(signal.bitLength));
+            signalItem->setText(2, signal.byteOrder == DBCByteOrder::Intel ? "Intel" : "Motorola");
+            signalItem->setText(3, QString::number(signal.factor));
+            signalItem->setText(4, QString::number(signal.offset));
+            signalItem->setText(5, QString("[%1|%2]").arg(signal.minimum).arg(signal.maximum));
+            signalItem->setText(6, QString::fromStdString(signal.unit));
+            signalItem->setText(7, QString::fromStdString(signal.comment));
+        }
+    }
+    tree->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+
+    QVBoxLayout *layout = new QVBoxLayout(dialog);
+    layout->addWidget(tree);
+    dialog->setLayout(layout);
+    dialog->show();
 }
 
 void MainWindow::updateStatus(const QString &status) {
@@ -138,6 +387,107 @@ void MainWindow::updateVoltage(double voltage) {
     voltageDisplay->display(voltage);
 }
 
+// Changes of the selected cell arrive through showLiveSample. The timer
+// only fills the display from the store after a selection or once the cell
+// reports again, and shows "--" until the cell has reported and whenever its
+// acquisition goes quiet, so a lost channel never leaves the last value on screen.
+void MainWindow::refreshLiveValues() {
+    if (selectedBench < 0 || selectedCell < 0) {
+        return;
+    }
+    const SignalValue temperature = signalStore.read(selectedBench, selectedCell, CellSignal::Temperature);
+    const SignalValue voltage = signalStore.read(selectedBench, selectedCell, CellSignal::Voltage);
+
+    const std::uint64_t nowUs = monotonicMicros();
+    const auto isFresh = [nowUs](const SignalValue& sample) {
+        return sample.timeUs != 0 && nowUs - std::min(nowUs, sample.timeUs) < LiveValueStaleUs;
+    };
+    if (!isFresh(temperature)) {
+        temperatureDisplay->display(QString("--"));
+        liveTemperatureShown = false;
+    } else if (!liveTemperatureShown) {
+        updateTemperature(temperature.value);
+        liveTemperatureShown = true;
+    }
+    if (!isFresh(voltage)) {
+        voltageDisplay->display(QString("--"));
+        liveVoltageShown = false;
+    } else if (!liveVoltageShown) {
+        updateVoltage(voltage.value);
+        liveVoltageShown = true;
+    }
+}
+
+void MainWindow::checkRxTimeouts() {
+    const std::uint64_t nowUs = monotonicMicros();
+    std::vector<RxTimeout> timedOut;
+    QStringList silent;
+    bool supervising = false;
+    for (std::size_t bench = 0; bench < rxTimeoutMonitors.size(); ++bench) {
+        const RxTimeoutMonitor* monitor = rxTimeoutMonitors[bench].get();
+        if (monitor == nullptr || monitor->messageCount() == 0) {
+            continue;
+        }
+        supervising = true;
+        timedOut.clear();
+        monitor->checkTimeouts(nowUs, timedOut);
+        for (const RxTimeout& timeout : timedOut) {
+            const DBCMessage* message = benchDatabase.findMessage(timeout.dbcId & 0x7FFFFFFFU, (timeout.dbcId & 0x80000000U) != 0);
+            const QString name = message != nullptr ? QString::fromStdString(message->name)
+                                                    : QString("0x%1").arg(timeout.dbcId & 0x7FFFFFFFU, 0, 16);
+            silent << QString("Bench %1 %2 (%3 ms)").arg(bench + 1).arg(name).arg(timeout.silentUs / 1000);
+        }
+    }
+    if (!supervising) {
+        rxStatusLabel->clear();
+    } else if (silent.isEmpty()) {
+        rxStatusLabel->setStyleSheet(QString());
+        rxStatusLabel->setText("CAN RX ok");
+    } else {
+        rxStatusLabel->setStyleSheet("color: red");
+        rxStatusLabel->setText(QString("CAN RX timeout: %1").arg(silent.join(", ")));
+    }
+}
+
+void MainWindow::showLiveSample(int cellIndex, CellSignal signal, double value) {
+    if (cellIndex != selectedBench * CellsPerBench + selectedCell) {
+        return;  // Posted before the selection changed
+    }
+    if (signal == CellSignal::Voltage) {
+        updateVoltage(value);
+        liveVoltageShown = true;
+    } else if (signal == CellSignal::Temperature) {
+        updateTemperature(value);
+        liveTemperatureShown = true;
+    }
+}
+
+void MainWindow::selectLiveCell(int bench, int cell) {
+    selectedBench = bench;
+    selectedCell = cell;
+    liveCellIndex.store(bench * CellsPerBench + cell, std::memory_order_relaxed);
+    liveVoltageShown = false;
+    liveTemperatureShown = false;
+    refreshLiveValues();
+}
+
+void MainWindow::onSelectLiveCell() {
+    bool ok = false;
+    const int bench = QInputDialog::getInt(this, "Live Cell", "Test Bench:", selectedBench < 0 ? 1 : selectedBench + 1,
+                                           1, BenchCount, 1, &ok);
+    if (!ok) {
+        return;
+    }
+    const int cell = QInputDialog::getInt(this, "Live Cell", "Cell Number:", selectedCell < 0 ? 1 : selectedCell + 1,
+                                          1, CellsPerBench, 1, &ok);
+    if (!ok) {
+        return;
+    }
+    testBenchLabel->setText(QString("Test Bench: %1").arg(bench));
+    cellNumberLabel->setText(QString("Cell Number: %1").arg(cell));
+    selectLiveCell(bench - 1, cell - 1);
+}
+
 void MainWindow::setupCentralWidget() {
     // Central Widget and Layout Setup
     QWidget *centralWidget = new QWidget(this);
@@ -223,7 +573,6 @@ void MainWindow::onTestBenchOptionSelected(int testBenchNumber, const QString &o
     bool ok;
     int cellNumber = QInputDialog::getInt(this, QString("Test Bench %1 - %2").arg(testBenchNumber).arg(option),
                                           "Enter Cell Number:", 1, 1, 50, 1, &ok);
-    TestOperations sharedOperations; // Shared TestOperations instance for all test benches 
 
     // If the user clicked OK and entered a valid number
     if (ok) {
@@ -239,23 +588,44 @@ void MainWindow::onTestBenchOptionSelected(int testBenchNumber, const QString &o
             return;
         }
 
-        // Create the TestBenchOperations object with the shared TestOperations
-        TestBenchOperations* testBench = new TestBenchOperations(testBenchNumber, cellNumber, sharedOperations, this);
-
-        // Run the test in a separate thread
-        std::thread testThread(&TestBenchOperations::performTest, testBench, testType);
-
-        // Detach the thread so it runs independently
-        testThread.detach();
+        // The step engine runs the test; this object only relays its progress
+        TestBenchOperations* testBench = new TestBenchOperations(testBenchNumber, cellNumber, testEngine, this);
+        connect(testBench, &TestBenchOperations::testStatusUpdated, this, &MainWindow::updateStatus);
+        connect(testBench, &TestBenchOperations::progressUpdated, this, &MainWindow::updateProgress);
+
+        // Registered before the test starts, so no status posted by the engine
+        // can miss it. The slot is connected ahead of deleteLater, so it runs first.
+        const int cellIndex = (testBenchNumber - 1) * CellsPerBench + (cellNumber - 1);
+        TestBenchOperations* previousTest = cellTests[cellIndex];
+        cellTests[cellIndex] = testBench;
+        const QMetaObject::Connection clearOnFinish =
+            connect(testBench, &TestBenchOperations::testFinished, this, [this, cellIndex, testBench]() {
+                if (cellTests[cellIndex] == testBench) {
+                    cellTests[cellIndex] = nullptr;
+                }
+            });
+        connect(testBench, &TestBenchOperations::testFinished, testBench, &QObject::deleteLater);
+        if (!testBench->performTest(testType)) {
+            disconnect(clearOnFinish);
+            cellTests[cellIndex] = previousTest;  // The test already running there stays registered
+            QMessageBox::warning(this, "Test Not Started",
+                                 testEngine.isMeasured(testBenchNumber - 1, cellNumber - 1)
+                                     ? QString("Cell %1 on Test Bench %2 is already running a test.").arg(cellNumber).arg(testBenchNumber)
+                                     : QString("Cell %1 on Test Bench %2 has no live measurements; check bench.cfg.")
+                                           .arg(cellNumber)
+                                           .arg(testBenchNumber));
+            testBench->deleteLater();
+            return;
+        }
 
         // Update the display labels with the selected test bench, cell number, and test type
         testBenchLabel->setText(QString("Test Bench: %1").arg(testBenchNumber));
         cellNumberLabel->setText(QString("Cell Number: %1").arg(cellNumber));
         testTypeLabel->setText(QString("Test Type: %1").arg(option));
 
-        // Example progress update
-        progressBar->setValue(50);  // Set progress value (for example purposes)
-        temperatureDisplay->display(25.0);  // Set a dummy temperature value
-        voltageDisplay->display(3.7);  // Set a dummy voltage value
+        progressBar->setValue(0);
+
+        // Live temperature/voltage now follow this cell
+        selectLiveCell(testBenchNumber - 1, cellNumber - 1);
     }
 }
\ No newline at end of file
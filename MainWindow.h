@@ -10,6 +10,26 @@
 #include <QMenu>        // Required for QMenu
 #include <QToolBar>     // Required for QToolBar
 #include <QTextEdit>
+#include <QTimer>
+#include "BenchExecutor.hpp"
+#include "bench_acquisition.hpp"
+#include "can_channel_manager.hpp"
+#include "can_transmit_queue.hpp"
+#include "cyclic_transmit_scheduler.hpp"
+#include "dbc_database.hpp"
+#include "power_stage_commands.hpp"
+#include "rx_timeout_monitor.hpp"
+#include "signal_decoder.hpp"
+#include "signal_encoder.hpp"
+#include "signal_store.hpp"
+#include "TestOperations.hpp"
+#include "TestStepEngine.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class TestBenchOperations;
 
 class MainWindow : public QMainWindow {
     Q_OBJECT  // This is critical for QObject-based classes
@@ -28,13 +48,22 @@ private:
     //void setupToolBar();
     void setupCentralWidget();
     void setupRightPanel();
+    void setupAcquisition();  // Wires the benches' CAN channels to signalStore from bench.cfg
+    TestBenchOperations* selectedTest();  // Test running on the selected cell, or nullptr
+    void selectLiveCell(int bench, int cell);  // Zero-based; the live display follows this cell
+    void showLiveSample(int cellIndex, CellSignal signal, double value);  // Filtered update from acquisition
 
-private slots:
+private Q_SLOTS:
     void onRunClicked();  // Slot to handle button click
     void onStopClicked();
+    void onPauseClicked();
+    void onResumeClicked();
     void onStartTestClicked();
     void onTestBenchOptionSelected(int testBenchNumber, const QString &option); // Slots for handling cell selection in Test Benches
-    //void onViewDBCMessage();
+    void onViewDBCMessage();
+    void refreshLiveValues();  // Polls the signal store for the selected bench/cell
+    void onSelectLiveCell();   // Points the live display at a cell without starting a test
+    void checkRxTimeouts();    // Shows the cyclic messages the benches stopped receiving
 
 private:
     QPushButton *startButton;
@@ -46,6 +75,39 @@ private:
     QProgressBar *progressBar;
     QLCDNumber *temperatureDisplay;
     QLCDNumber *voltageDisplay;
+
+    DBCDatabase dbcDatabase;  // Last DBC file loaded through "View DBC Messages"
+
+    static constexpr int BenchCount = 3;
+    static constexpr int CellsPerBench = 50;
+    static constexpr int LiveValueIntervalMs = 100;
+    static constexpr std::uint64_t LiveValueStaleUs = 2000000;  // Older samples show as "--"
+    static constexpr int RxTimeoutCheckIntervalMs = 500;
+
+    SignalStore signalStore;  // Latest decoded values, written by the acquisition threads
+    // Acquisition path, empty while bench.cfg is missing. Declared in
+    // dependency order so the acquisition and transmit threads stop first.
+    DBCDatabase benchDatabase;  // DBC named by bench.cfg
+    std::unique_ptr<SignalDecoder> signalDecoder;
+    std::unique_ptr<SignalEncoder> signalEncoder;
+    std::unique_ptr<CANChannelManager> channelManager;
+    std::vector<std::unique_ptr<CANTransmitQueue>> transmitQueues;  // Indexed by bench, nullptr when not wired
+    std::vector<std::unique_ptr<PowerStageCommands>> powerStages;   // Indexed by bench, nullptr when not wired
+    std::unique_ptr<CyclicTransmitScheduler> cyclicScheduler;       // Only with a node in bench.cfg
+    std::vector<std::unique_ptr<RxTimeoutMonitor>> rxTimeoutMonitors;  // Indexed by bench, nullptr when not wired
+    std::vector<std::unique_ptr<BenchAcquisition>> benchAcquisitions;
+    BenchExecutor benchExecutor;    // Worker threads for bench jobs; outlives testEngine
+    TestOperations testOperations;  // Power stages of all benches
+    TestStepEngine testEngine;      // Runs the step sequences of every started test
+    std::vector<TestBenchOperations*> cellTests;  // Running test per bench * CellsPerBench + cell, nullptr when idle
+    QTimer *liveValueTimer;
+    QTimer *rxTimeoutTimer;
+    QLabel *rxStatusLabel;  // Permanent status bar entry, next to the acquisition summary
+    int selectedBench = -1;   // Zero-based, -1 until a test bench option is chosen
+    int selectedCell = -1;
+    std::atomic<int> liveCellIndex{-1};  // selectedBench * CellsPerBench + selectedCell, read by acquisition threads
+    bool liveVoltageShown = false;       // Display holds a value of the selected cell, not "--"
+    bool liveTemperatureShown = false;
 };
 
 #endif // MAINWINDOW_H
@@ -91,7 +91,11 @@
 #define PCAN_LANBUS14                 0x80EU  // PCAN-LAN interface, channel 14
 #define PCAN_LANBUS15                 0x80FU  // PCAN-LAN interface, channel 15
 #define PCAN_LANBUS16                 0x810U  // PCAN-LAN interface, channel 16
+#ifdef _WIN32
 #include <windows.h>
+#else
+#include "win_compat_types.h"
+#endif
 
 
 // Represent the PCAN error and status codes 
@@ -1,90 +1,134 @@
 #include "TestBenchOperations.hpp"
-#include "MainWindow.h"  // Include MainWindow header
-#include <iostream>
+#include <algorithm>
+#include <chrono>
 
-//TestBenchOperations::TestBenchOperations(int testBenchNumber, int cellNumber, TestOperations& sharedOperations)
-    //: testBenchNumber_(testBenchNumber), cellNumber_(cellNumber), operations_(sharedOperations) {}
+using namespace std::chrono_literals;
 
-TestBenchOperations::TestBenchOperations(int testBenchNumber, int cellNumber, TestOperations& sharedOperations, MainWindow *mainWindow)
-    : testBenchNumber_(testBenchNumber), cellNumber_(cellNumber), operations_(sharedOperations), mainWindow_(mainWindow) {}
+namespace {
 
-void TestBenchOperations::performTest(TestType testType) {
-    std::lock_guard<std::mutex> lock(threadMutex_);  // Ensure only one test per test bench
+// Single Li-ion cell limits
+constexpr double ChargeCurrentA = 1.0;
+constexpr double ChargeVoltageV = 4.2;
+constexpr double ChargeCutoffCurrentA = 0.05;
+constexpr double DischargeCurrentA = -1.0;
+constexpr double DischargeCutoffVoltageV = 2.8;
+constexpr double PulseCurrentA = 2.0;
+constexpr int PulseCount = 3;
 
+// co_awaits per procedure, for the progress bar
+constexpr std::size_t CccvChargeSteps = 5;
+constexpr std::size_t CcDischargeSteps = 3;
+constexpr std::size_t RptSteps = 6 * PulseCount;
+
+} // namespace
+
+TestBenchOperations::TestBenchOperations(int testBenchNumber, int cellNumber, TestStepEngine& engine, QObject *parent)
+    : QObject(parent), testBenchNumber_(testBenchNumber), cellNumber_(cellNumber), engine_(engine) {}
+
+bool TestBenchOperations::performTest(TestType testType) {
+    QString testName;
+    TestProcedure procedure;
+    std::size_t plannedSteps = 0;
     switch (testType) {
     case TestType::CCCV_ChargeCycle:
-        performCCCVChargeCycle();
+        testName = "CCCV Charge Cycle";
+        procedure = cccvChargeCycle();
+        plannedSteps = CccvChargeSteps;
         break;
     case TestType::CC_DischargeCycle:
-        performCCDischargeCycle();
+        testName = "CC Discharge Cycle";
+        procedure = ccDischargeCycle();
+        plannedSteps = CcDischargeSteps;
         break;
     case TestType::RPT_Test:
-        performRPTTest();
+        testName = "RPT Test";
+        procedure = rptTest();
+        plannedSteps = RptSteps;
         break;
     }
-}
-
-void TestBenchOperations::performCCCVChargeCycle() {
-    //std::cout << "Starting CCCV Charge Cycle on Test Bench: " << testBenchNumber_ << ", Cell: " << cellNumber_ << std::endl;
-    mainWindow_->updateStatus(QString("Starting CCCV Charge Cycle on Test Bench: %1, Cell: %2").arg(testBenchNumber_).arg(cellNumber_));
-
-    operations_.subMethod1();
-    mainWindow_->updateProgress(25);
-
-    operations_.subMethod2();
-    mainWindow_->updateProgress(50);
-
-    operations_.subMethod3();
-    mainWindow_->updateProgress(75);
 
-    operations_.subMethod4();
-    mainWindow_->updateProgress(100);
-
-    //std::cout << "CCCV Charge Cycle completed on Test Bench: " << testBenchNumber_
-              //<< ", Cell: " << cellNumber_ << std::endl;
-    mainWindow_->updateStatus(QString("CCCV Charge Cycle completed on Test Bench: %1, Cell: %2").arg(testBenchNumber_).arg(cellNumber_));
+    // The engine reports from executor threads. Each status is posted to this
+    // object's (GUI) thread first, so every signal, testFinished and the
+    // deleteLater it triggers included, happens there and in engine order.
+    testId_ = engine_.startTest(testBenchNumber_ - 1, cellNumber_ - 1, std::move(procedure),
+                                [this, testName](TestId, const TestStatus &status) {
+                                    QMetaObject::invokeMethod(this, [this, testName, status]() { onEngineStatus(testName, status); },
+                                                              Qt::QueuedConnection);
+                                },
+                                cancellation_.token(), plannedSteps);
+    if (testId_ == InvalidTestId) {
+        const bool measured = engine_.isMeasured(testBenchNumber_ - 1, cellNumber_ - 1);
+        Q_EMIT testStatusUpdated(QString("Test Bench: %1, Cell: %2 %3")
+                                     .arg(testBenchNumber_)
+                                     .arg(cellNumber_)
+                                     .arg(measured ? "is already running a test" : "has no live measurements (see bench.cfg)"));
+        return false;
+    }
+    Q_EMIT testStatusUpdated(QString("Starting %1 on Test Bench: %2, Cell: %3").arg(testName).arg(testBenchNumber_).arg(cellNumber_));
+    return true;
 }
 
-void TestBenchOperations::performCCDischargeCycle() {
-    //std::cout << "Starting CC Discharge Cycle on Test Bench: " << testBenchNumber_ << ", Cell: " << cellNumber_ << std::endl;
-    mainWindow_->updateStatus(QString("Starting CC Discharge Cycle on Test Bench: %1, Cell: %2").arg(testBenchNumber_).arg(cellNumber_));
-
-    operations_.subMethod1();
-    mainWindow_->updateProgress(25);
-
-    operations_.subMethod2();
-    mainWindow_->updateProgress(50);
-
-    operations_.subMethod3();
-    mainWindow_->updateProgress(75);
-
-    operations_.subMethod4();
-    mainWindow_->updateProgress(100);
-
-    //std::cout << "CC Discharge Cycle completed on Test Bench: " << testBenchNumber_
-              //<< ", Cell: " << cellNumber_ << std::endl;
-
-    mainWindow_->updateStatus(QString("CC Discharge Cycle completed on Test Bench: %1, Cell: %2").arg(testBenchNumber_).arg(cellNumber_));          
+void TestBenchOperations::stop() {
+    cancellation_.cancel();
 }
 
-void TestBenchOperations::performRPTTest() {
-    //std::cout << "Starting RPT Test on Test Bench: " << testBenchNumber_ << ", Cell: " << cellNumber_ << std::endl;
-    mainWindow_->updateStatus(QString("Starting RPT Test on Test Bench: %1, Cell: %2").arg(testBenchNumber_).arg(cellNumber_));
-
-    operations_.subMethod1();
-    mainWindow_->updateProgress(25);
+void TestBenchOperations::pause() {
+    engine_.pauseTest(testId_);
+}
 
-    operations_.subMethod2();
-    mainWindow_->updateProgress(50);
+void TestBenchOperations::resume() {
+    engine_.resumeTest(testId_);
+}
 
-    operations_.subMethod3();
-    mainWindow_->updateProgress(75);
+void TestBenchOperations::onEngineStatus(const QString &testName, const TestStatus &status) {
+    if (status.state == TestState::Completed) {
+        Q_EMIT progressUpdated(100);
+    } else if (status.stepCount != 0) {
+        Q_EMIT progressUpdated(static_cast<int>(std::min(status.stepIndex, status.stepCount) * 100 / status.stepCount));
+    }
+    switch (status.state) {
+    case TestState::Running:
+        break;
+    case TestState::Paused:
+        Q_EMIT testStatusUpdated(QString("%1 paused on Test Bench: %2, Cell: %3").arg(testName).arg(testBenchNumber_).arg(cellNumber_));
+        break;
+    case TestState::Cancelled:
+        Q_EMIT testStatusUpdated(QString("%1 stopped on Test Bench: %2, Cell: %3").arg(testName).arg(testBenchNumber_).arg(cellNumber_));
+        break;
+    case TestState::Completed:
+        Q_EMIT testStatusUpdated(QString("%1 completed on Test Bench: %2, Cell: %3").arg(testName).arg(testBenchNumber_).arg(cellNumber_));
+        break;
+    case TestState::Failed:
+        Q_EMIT testStatusUpdated(QString("%1 failed on Test Bench: %2, Cell: %3 (%4)")
+                                   .arg(testName).arg(testBenchNumber_).arg(cellNumber_).arg(QString::fromStdString(status.message)));
+        break;
+    }
+    if (status.state != TestState::Running && status.state != TestState::Paused) {
+        Q_EMIT testFinished();
+    }
+}
 
-    operations_.subMethod4();
-    mainWindow_->updateProgress(100);
+TestProcedure TestBenchOperations::cccvChargeCycle() {
+    co_await TestStep::setCurrent(ChargeCurrentA);
+    co_await waitForVoltageAbove(ChargeVoltageV, 3h);        // CC phase
+    co_await TestStep::setVoltage(ChargeVoltageV);
+    co_await waitForCurrentBelow(ChargeCutoffCurrentA, 2h);  // CV phase
+    co_await TestStep::rest(30min);
+}
 
-    //std::cout << "RPT Test completed on Test Bench: " << testBenchNumber_
-              //<< ", Cell: " << cellNumber_ << std::endl;
+TestProcedure TestBenchOperations::ccDischargeCycle() {
+    co_await TestStep::setCurrent(DischargeCurrentA);
+    co_await waitForVoltageBelow(DischargeCutoffVoltageV, 3h);
+    co_await TestStep::rest(30min);
+}
 
-    mainWindow_->updateStatus(QString("RPT Test completed on Test Bench: %1, Cell: %2").arg(testBenchNumber_).arg(cellNumber_));
-}
\ No newline at end of file
+TestProcedure TestBenchOperations::rptTest() {
+    for (int pulse = 0; pulse < PulseCount; ++pulse) {
+        co_await TestStep::setCurrent(-PulseCurrentA);  // Discharge pulse
+        co_await delay(10s);
+        co_await TestStep::rest(40s);
+        co_await TestStep::setCurrent(PulseCurrentA);   // Charge pulse
+        co_await delay(10s);
+        co_await TestStep::rest(40s);
+    }
+}
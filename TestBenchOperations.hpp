@@ -1,49 +1,47 @@
 #ifndef TESTBENCHOPERATIONS_HPP
 #define TESTBENCHOPERATIONS_HPP
 
-#include "TestOperations.hpp"
+#include "TestStepEngine.hpp"
 #include "TestType.hpp"
 #include <QObject> // 01.09 Updated
-#include <thread>
-#include <mutex>
-#include <stdexcept>
 
-// Forward declaration of MainWindow class
-class MainWindow;
- 
 //class TestBenchOperations {
 class TestBenchOperations : public QObject { // 01.09 Updated
     Q_OBJECT // 01.09 Updated
 
 public:
-    //TestBenchOperations(int testBenchNumber, int cellNumber, TestOperations& sharedOperations);
-    TestBenchOperations(int testBenchNumber, int cellNumber, TestOperations& sharedOperations, MainWindow *mainWindow);
-    
-    void performTest(TestType testType);
-    
-    //bool isTestRunning() const; 
-
-    //class TestRunningException : public std::runtime_error {
-    //public:
-        //TestRunningException(const std::string& message) : std::runtime_error(message) {}
-    //};
-    void performCCCVChargeCycle();
-    void performCCDischargeCycle();
-    void performRPTTest();
-
-signals: // 01.09 Updated 
+    TestBenchOperations(int testBenchNumber, int cellNumber, TestStepEngine& engine, QObject *parent = nullptr);
+
+    // Hands the test's step sequence to the engine and returns immediately;
+    // progress and the result arrive through the signals below
+    bool performTest(TestType testType);
+
+    // Take effect within one engine control period and leave the output off;
+    // resume() restores the setpoint the test was at
+    void stop();
+    void pause();
+    void resume();
+
+    // The test procedures, run by the engine
+    static TestProcedure cccvChargeCycle();
+    static TestProcedure ccDischargeCycle();
+    static TestProcedure rptTest();
+
+Q_SIGNALS: // 01.09 Updated 
     void testStatusUpdated(const QString &status);
     void progressUpdated(int value);
     void temperatureUpdated(double temperature);
     void voltageUpdated(double voltage);
+    void testFinished();  // Completed or failed; the engine no longer calls back
 
 private:
+    void onEngineStatus(const QString &testName, const TestStatus &status);  // On the GUI thread
+
     int testBenchNumber_;
     int cellNumber_;
-    TestOperations& operations_;  // Shared resource
-    std::mutex threadMutex_;  // To ensure one test bench runs only one test at a time
-    MainWindow *mainWindow_; // Pointer to the main window for UI updates
-   // bool testRunning_ = false;
+    TestStepEngine& engine_;
+    CancellationSource cancellation_;
+    TestId testId_ = InvalidTestId;
 };
 
 #endif // TESTBENCHOPERATIONS_HPP
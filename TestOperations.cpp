@@ -1,58 +1,61 @@
 #include "TestOperations.hpp"
 #include <iostream>
 
-void TestOperations::subMethod1() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    std::cout << "Executing SubMethod 1 (This will take some time)" << std::endl;
-
-    const unsigned long long countLimit = 10000000000ULL;
-    unsigned long long counter = 0;
-
-    while (counter < countLimit) {
-        ++counter;
+TestOperations::TestOperations(std::size_t benchCount, std::size_t cellsPerBench) {
+    for (std::size_t i = 0; i < benchCount; ++i) {
+        channels_.push_back(std::make_unique<Channel>());
+        benches_.push_back(std::make_unique<Bench>());
+        benches_.back()->cells_.resize(cellsPerBench);
+        benches_.back()->channel_ = channels_.back().get();
     }
-
-    std::cout << "SubMethod 1 completed." << std::endl;
 }
 
-void TestOperations::subMethod2() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    std::cout << "Executing SubMethod 2" << std::endl;
-
-    const unsigned long long countLimit = 500000000ULL;
-    unsigned long long counter = 0;
-
-    while (counter < countLimit) {
-        ++counter;
+void TestOperations::assignChannel(std::size_t bench, std::size_t channel) {
+    while (channels_.size() <= channel) {
+        channels_.push_back(std::make_unique<Channel>());
     }
-
-    std::cout << "SubMethod 2 completed." << std::endl;
+    benches_[bench]->channel_ = channels_[channel].get();
 }
 
-void TestOperations::subMethod3() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    std::cout << "Executing SubMethod 3" << std::endl;
-
-    const unsigned long long countLimit = 500000000ULL;
-    unsigned long long counter = 0;
+void TestOperations::setCurrent(std::size_t bench, std::size_t cell, double amps) {
+    apply(bench, cell, CellSetpoint{SetpointMode::Current, amps});
+}
 
-    while (counter < countLimit) {
-        ++counter;
-    }
+void TestOperations::setVoltage(std::size_t bench, std::size_t cell, double volts) {
+    apply(bench, cell, CellSetpoint{SetpointMode::Voltage, volts});
+}
 
-    std::cout << "SubMethod 3 completed." << std::endl;
+void TestOperations::outputOff(std::size_t bench, std::size_t cell) {
+    apply(bench, cell, CellSetpoint{SetpointMode::Off, 0.0});
 }
 
-void TestOperations::subMethod4() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    std::cout << "Executing SubMethod 4" << std::endl;
+CellSetpoint TestOperations::setpoint(std::size_t bench, std::size_t cell) const {
+    const Bench& resources = *benches_[bench];
+    std::lock_guard<std::mutex> lock(resources.mutex_);
+    return resources.cells_[cell];
+}
 
-    const unsigned long long countLimit = 500000000ULL;
-    unsigned long long counter = 0;
+void TestOperations::apply(std::size_t bench, std::size_t cell, CellSetpoint setpoint) {
+    Bench& resources = *benches_[bench];
+    std::lock_guard<std::mutex> benchLock(resources.mutex_);
+    resources.cells_[cell] = setpoint;
 
-    while (counter < countLimit) {
-        ++counter;
+    // The bus is the only resource benches may share
+    std::lock_guard<std::mutex> channelLock(resources.channel_->mutex_);
+    if (sink_) {
+        sink_(bench, cell, setpoint);
+        return;
+    }
+    std::cout << "Bench " << bench + 1 << ", Cell " << cell + 1 << ": ";
+    switch (setpoint.mode) {
+    case SetpointMode::Off:
+        std::cout << "output off" << std::endl;
+        break;
+    case SetpointMode::Current:
+        std::cout << "constant current " << setpoint.value << " A" << std::endl;
+        break;
+    case SetpointMode::Voltage:
+        std::cout << "constant voltage " << setpoint.value << " V" << std::endl;
+        break;
     }
-
-    std::cout << "SubMethod 4 completed." << std::endl;
 }
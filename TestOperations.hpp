@@ -1,17 +1,69 @@
 #ifndef TESTOPERATIONS_HPP
 #define TESTOPERATIONS_HPP
 
+#include "TestStepEngine.hpp"
+#include <functional>
+#include <memory>
 #include <mutex>
+#include <vector>
 
-class TestOperations {
+enum class SetpointMode {
+    Off,
+    Current,
+    Voltage
+};
+
+struct CellSetpoint {
+    SetpointMode mode = SetpointMode::Off;
+    double value = 0.0;
+};
+
+// Power-stage access for all test benches.
+//
+// Every bench owns its resources (the setpoints of its cells and the lock
+// guarding them), so tests on different benches never wait for each other.
+// Only benches that are wired to the same CAN channel also serialize on
+// that channel's arbitration lock while a command goes out.
+class TestOperations : public CellPowerControl {
 public:
-    void subMethod1();
-    void subMethod2();
-    void subMethod3();
-    void subMethod4();
+    // Puts one setpoint command on the bench's channel; runs with the
+    // bench's and the channel's lock held
+    using CommandSink = std::function<void(std::size_t bench, std::size_t cell, const CellSetpoint& setpoint)>;
+
+    TestOperations(std::size_t benchCount, std::size_t cellsPerBench);
+
+    // Replaces the default sink, which logs commands to std::cout. Call
+    // before any test starts.
+    void setCommandSink(CommandSink sink) { sink_ = std::move(sink); }
+
+    // Routes bench's commands over channel; benches on the same channel
+    // share its arbitration. By default bench n uses channel n. Call before
+    // any test starts.
+    void assignChannel(std::size_t bench, std::size_t channel);
+
+    void setCurrent(std::size_t bench, std::size_t cell, double amps) override;
+    void setVoltage(std::size_t bench, std::size_t cell, double volts) override;
+    void outputOff(std::size_t bench, std::size_t cell) override;
+
+    // Last commanded setpoint of a cell
+    CellSetpoint setpoint(std::size_t bench, std::size_t cell) const;
 
 private:
-    std::mutex mutex_;
+    struct Channel {
+        std::mutex mutex_;  // Held while a command is on its way to the bus
+    };
+
+    struct Bench {
+        mutable std::mutex mutex_;  // Guards cells_
+        std::vector<CellSetpoint> cells_;
+        Channel* channel_ = nullptr;
+    };
+
+    void apply(std::size_t bench, std::size_t cell, CellSetpoint setpoint);
+
+    std::vector<std::unique_ptr<Channel>> channels_;
+    std::vector<std::unique_ptr<Bench>> benches_;
+    CommandSink sink_;
 };
 
 #endif // TESTOPERATIONS_HPP
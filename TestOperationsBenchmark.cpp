@@ -0,0 +1,66 @@
+// Drives N benches through TestOperations in parallel and reports the
+// command throughput against a single bench. Every command occupies its
+// channel for one CAN frame time, as a real transmission would, so benches
+// on their own channels should scale near-linearly while benches sharing a
+// channel serialize on it.
+//
+// Usage: test_operations_benchmark [maxBenches] [commandsPerBench]
+#include "TestOperations.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t CellsPerBench = 50;
+constexpr std::chrono::microseconds FrameTime{230};  // 8-byte frame at 500 kbit/s
+
+// Returns commands per second over all benches
+double run(std::size_t benchCount, std::size_t commandsPerBench, bool sharedChannel) {
+    TestOperations operations(benchCount, CellsPerBench);
+    operations.setCommandSink([](std::size_t, std::size_t, const CellSetpoint&) { std::this_thread::sleep_for(FrameTime); });
+    if (sharedChannel) {
+        for (std::size_t bench = 0; bench < benchCount; ++bench) {
+            operations.assignChannel(bench, 0);
+        }
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (std::size_t bench = 0; bench < benchCount; ++bench) {
+        threads.emplace_back([&operations, bench, commandsPerBench] {
+            for (std::size_t i = 0; i < commandsPerBench; ++i) {
+                const std::size_t cell = i % CellsPerBench;
+                switch (i % 3) {
+                case 0: operations.setCurrent(bench, cell, 1.0); break;
+                case 1: operations.setVoltage(bench, cell, 4.2); break;
+                default: operations.outputOff(bench, cell); break;
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(benchCount * commandsPerBench) / elapsed.count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t maxBenches = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 8;
+    const std::size_t commandsPerBench = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2000;
+
+    std::printf("%7s %16s %8s %16s %8s\n", "benches", "own channel/s", "speedup", "shared channel/s", "speedup");
+    const double ownBaseline = run(1, commandsPerBench, false);
+    const double sharedBaseline = run(1, commandsPerBench, true);
+    for (std::size_t benches = 1; benches <= maxBenches; benches *= 2) {
+        const double own = benches == 1 ? ownBaseline : run(benches, commandsPerBench, false);
+        const double shared = benches == 1 ? sharedBaseline : run(benches, commandsPerBench, true);
+        std::printf("%7zu %16.0f %7.2fx %16.0f %7.2fx\n", benches, own, own / ownBaseline, shared, shared / sharedBaseline);
+    }
+    return 0;
+}
@@ -0,0 +1,148 @@
+#ifndef TESTPROCEDURE_HPP
+#define TESTPROCEDURE_HPP
+
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+#include <vector>
+
+enum class StepKind {
+    SetCurrent,        // Constant current of value amps
+    SetVoltage,        // Constant voltage of value volts
+    Rest,              // Output off for duration
+    Hold,              // Keep the present setpoint for duration
+    WaitVoltageAbove,  // Until a voltage sample >= value
+    WaitVoltageBelow,  // Until a voltage sample <= value
+    WaitCurrentBelow   // Until a current sample's magnitude <= value (end of CV phase)
+};
+
+struct TestStep {
+    StepKind kind;
+    double value = 0.0;
+    std::chrono::milliseconds duration{0};  // Rest/Hold time, or timeout of a wait (0 = none)
+
+    static TestStep setCurrent(double amps) { return TestStep{StepKind::SetCurrent, amps}; }
+    static TestStep setVoltage(double volts) { return TestStep{StepKind::SetVoltage, volts}; }
+    static TestStep rest(std::chrono::milliseconds time) { return TestStep{StepKind::Rest, 0.0, time}; }
+    static TestStep hold(std::chrono::milliseconds time) { return TestStep{StepKind::Hold, 0.0, time}; }
+    static TestStep waitVoltageAbove(double volts, std::chrono::milliseconds timeout) {
+        return TestStep{StepKind::WaitVoltageAbove, volts, timeout};
+    }
+    static TestStep waitVoltageBelow(double volts, std::chrono::milliseconds timeout) {
+        return TestStep{StepKind::WaitVoltageBelow, volts, timeout};
+    }
+    static TestStep waitCurrentBelow(double amps, std::chrono::milliseconds timeout) {
+        return TestStep{StepKind::WaitCurrentBelow, amps, timeout};
+    }
+};
+
+// Shorthands for procedure code: co_await delay(10s), co_await waitForVoltageAbove(4.2, 3h)
+inline TestStep delay(std::chrono::milliseconds time) { return TestStep::hold(time); }
+inline TestStep waitForVoltageAbove(double volts, std::chrono::milliseconds timeout) {
+    return TestStep::waitVoltageAbove(volts, timeout);
+}
+inline TestStep waitForVoltageBelow(double volts, std::chrono::milliseconds timeout) {
+    return TestStep::waitVoltageBelow(volts, timeout);
+}
+inline TestStep waitForCurrentBelow(double amps, std::chrono::milliseconds timeout) {
+    return TestStep::waitCurrentBelow(amps, timeout);
+}
+
+// A test written as straight-line code. A procedure is a coroutine that
+// co_awaits TestSteps; each co_await hands the step to the TestStepEngine
+// and suspends until the engine has carried it out, so a waiting procedure
+// costs its coroutine frame and no thread. co_await evaluates to the sample
+// that ended a wait step (0 for other steps). A wait that times out fails
+// the test and the procedure is never resumed; an exception escaping the
+// procedure fails it as well.
+//
+//     TestProcedure charge() {
+//         co_await TestStep::setCurrent(1.0);
+//         co_await waitForVoltageAbove(4.2, 3h);
+//         co_await delay(10s);
+//     }
+//
+// Procedures start suspended and run only inside the engine, on its
+// executor threads, so they must not block or call back into the engine.
+class TestProcedure {
+public:
+    struct promise_type;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    struct StepAwaiter {
+        Handle handle;
+        TestStep step;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(Handle) noexcept { handle.promise().step = step; }
+        double await_resume() const noexcept { return handle.promise().result; }
+    };
+
+    struct promise_type {
+        std::optional<TestStep> step;  // Awaited step the engine has not taken yet
+        double result = 0.0;
+        std::exception_ptr exception;
+
+        TestProcedure get_return_object() { return TestProcedure(Handle::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { exception = std::current_exception(); }
+        StepAwaiter await_transform(TestStep awaited) noexcept { return StepAwaiter{Handle::from_promise(*this), awaited}; }
+    };
+
+    TestProcedure() = default;
+    TestProcedure(TestProcedure&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+    TestProcedure& operator=(TestProcedure&& other) noexcept {
+        if (this != &other) {
+            reset();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+    ~TestProcedure() { reset(); }
+
+    TestProcedure(const TestProcedure&) = delete;
+    TestProcedure& operator=(const TestProcedure&) = delete;
+
+    bool isValid() const { return handle_ != nullptr; }
+
+    // Runs the procedure up to its next co_await, passing result in as the
+    // value of the previous one. Returns that step, or nothing once the
+    // procedure has returned or thrown.
+    std::optional<TestStep> next(double result) {
+        if (!handle_ || handle_.done()) {
+            return std::nullopt;
+        }
+        handle_.promise().result = result;
+        handle_.promise().step.reset();
+        handle_.resume();
+        return handle_.done() ? std::nullopt : handle_.promise().step;
+    }
+
+    // Exception that ended the procedure, if any
+    std::exception_ptr exception() const { return handle_ ? handle_.promise().exception : nullptr; }
+
+private:
+    explicit TestProcedure(Handle handle) : handle_(handle) {}
+
+    void reset() {
+        if (handle_) {
+            handle_.destroy();
+            handle_ = nullptr;
+        }
+    }
+
+    Handle handle_;
+};
+
+// Procedure that runs a fixed step list in order
+inline TestProcedure stepSequence(std::vector<TestStep> steps) {
+    for (const TestStep& step : steps) {
+        co_await step;
+    }
+}
+
+#endif // TESTPROCEDURE_HPP
@@ -0,0 +1,331 @@
+#include "TestStepEngine.hpp"
+#include "monotonic_clock.hpp"
+#include <algorithm>
+#include <cmath>
+
+TestStepEngine::TestStepEngine(const SignalStore& store, CellPowerControl& power, BenchExecutor& executor)
+    : store_(store), power_(power), executor_(executor) {
+    for (std::size_t i = 0; i < store.benchCount(); ++i) {
+        benches_.push_back(std::make_unique<BenchTests>());
+        benches_.back()->acquired_.resize(store.cellCount(), 0);
+    }
+    thread_ = std::thread(&TestStepEngine::engineLoop, this);
+}
+
+TestStepEngine::~TestStepEngine() {
+    running_.store(false);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    // Never leave a power stage running without supervision
+    for (const std::unique_ptr<BenchTests>& bench : benches_) {
+        std::lock_guard<std::mutex> lock(bench->mutex_);
+        for (const RunningTest& test : bench->tests_) {
+            power_.outputOff(test.bench, test.cell);
+        }
+    }
+}
+
+void TestStepEngine::setAcquired(std::size_t bench, std::size_t cell, CellSignal signal, bool acquired) {
+    if (bench >= benches_.size() || cell >= store_.cellCount()) {
+        return;
+    }
+    BenchTests& benchTests = *benches_[bench];
+    const std::uint8_t bit = static_cast<std::uint8_t>(1U << static_cast<unsigned>(signal));
+    std::lock_guard<std::mutex> lock(benchTests.mutex_);
+    if (acquired) {
+        benchTests.acquired_[cell] |= bit;
+    } else {
+        benchTests.acquired_[cell] &= static_cast<std::uint8_t>(~bit);
+    }
+}
+
+bool TestStepEngine::isMeasured(std::size_t bench, std::size_t cell) const {
+    if (bench >= benches_.size() || cell >= store_.cellCount()) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(benches_[bench]->mutex_);
+    return benches_[bench]->acquired_[cell] != 0;
+}
+
+TestId TestStepEngine::startTest(std::size_t bench, std::size_t cell, TestProcedure procedure, StatusCallback onStatus,
+                                 CancellationToken cancellation, std::size_t plannedSteps) {
+    if (bench >= benches_.size() || cell >= store_.cellCount() || !procedure.isValid()) {
+        return InvalidTestId;
+    }
+    BenchTests& benchTests = *benches_[bench];
+    std::lock_guard<std::mutex> lock(benchTests.mutex_);
+    if (benchTests.acquired_[cell] == 0) {
+        return InvalidTestId;  // Wait steps could never see the cell
+    }
+    for (const RunningTest& test : benchTests.tests_) {
+        if (test.cell == cell) {
+            return InvalidTestId;
+        }
+    }
+    RunningTest test;
+    test.id = nextId_.fetch_add(1);
+    test.bench = bench;
+    test.cell = cell;
+    test.procedure = std::move(procedure);
+    test.plannedSteps = plannedSteps;
+    test.onStatus = std::move(onStatus);
+    test.cancellation = std::move(cancellation);
+    benchTests.tests_.push_back(std::move(test));
+    return benchTests.tests_.back().id;
+}
+
+TestId TestStepEngine::startTest(std::size_t bench, std::size_t cell, std::vector<TestStep> steps, StatusCallback onStatus,
+                                 CancellationToken cancellation) {
+    const std::size_t plannedSteps = steps.size();
+    return startTest(bench, cell, stepSequence(std::move(steps)), std::move(onStatus), std::move(cancellation),
+                     plannedSteps);
+}
+
+bool TestStepEngine::pauseTest(TestId id) {
+    return requestPause(id, true);
+}
+
+bool TestStepEngine::resumeTest(TestId id) {
+    return requestPause(id, false);
+}
+
+bool TestStepEngine::requestPause(TestId id, bool pause) {
+    for (const std::unique_ptr<BenchTests>& bench : benches_) {
+        std::lock_guard<std::mutex> lock(bench->mutex_);
+        for (RunningTest& test : bench->tests_) {
+            if (test.id == id) {
+                test.pauseRequested = pause;  // Applied by the test's next period
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+std::size_t TestStepEngine::activeTestCount() const {
+    std::size_t count = 0;
+    for (const std::unique_ptr<BenchTests>& bench : benches_) {
+        std::lock_guard<std::mutex> lock(bench->mutex_);
+        count += bench->tests_.size();
+    }
+    return count;
+}
+
+void TestStepEngine::poll(std::uint64_t nowUs) {
+    std::vector<BenchJobHandle> jobs;
+    for (const std::unique_ptr<BenchTests>& bench : benches_) {
+        {
+            std::lock_guard<std::mutex> lock(bench->mutex_);
+            if (bench->tests_.empty()) {
+                continue;
+            }
+        }
+        BenchTests* benchTests = bench.get();
+        BenchJobHandle job = executor_.submit([this, benchTests, nowUs](const CancellationToken&) { pollBench(*benchTests, nowUs); });
+        if (!job.isValid()) {
+            pollBench(*benchTests, nowUs);  // Executor already shut down
+        }
+        jobs.push_back(std::move(job));
+    }
+    // The next period must not start while a bench is still being advanced
+    for (const BenchJobHandle& job : jobs) {
+        job.wait();
+    }
+}
+
+void TestStepEngine::pollBench(BenchTests& bench, std::uint64_t nowUs) {
+    std::vector<Notification> notifications;
+    {
+        std::lock_guard<std::mutex> lock(bench.mutex_);
+        bench.tests_.erase(std::remove_if(bench.tests_.begin(), bench.tests_.end(),
+                                          [&](RunningTest& test) {
+                                              return !advance(test, bench.acquired_[test.cell], nowUs, notifications);
+                                          }),
+                           bench.tests_.end());
+    }
+    // Outside the lock, so callbacks may start further tests
+    for (const Notification& notification : notifications) {
+        if (notification.callback) {
+            notification.callback(notification.id, notification.status);
+        }
+    }
+}
+
+bool TestStepEngine::advance(RunningTest& test, std::uint8_t acquired, std::uint64_t nowUs,
+                             std::vector<Notification>& notifications) {
+    if (!applyRequests(test, nowUs, notifications)) {
+        return false;
+    }
+    if (test.paused) {
+        return true;
+    }
+
+    // Instant steps (setpoints) chain within the same period
+    for (;;) {
+        if (!test.entered) {
+            if (!enterStep(test, nowUs)) {
+                break;
+            }
+            notifications.push_back(Notification{test.onStatus, test.id, status(test, TestState::Running)});
+        }
+
+        const TestStep& step = test.step;
+        const std::uint64_t elapsedUs = nowUs - test.stepStartUs;
+        const std::uint64_t durationUs = static_cast<std::uint64_t>(step.duration.count()) * 1000;
+        bool done = false;
+        double result = 0.0;
+        switch (step.kind) {
+        case StepKind::SetCurrent:
+        case StepKind::SetVoltage:
+            done = true;
+            break;
+        case StepKind::Rest:
+        case StepKind::Hold:
+            done = elapsedUs >= durationUs;
+            break;
+        case StepKind::WaitVoltageAbove:
+        case StepKind::WaitVoltageBelow:
+        case StepKind::WaitCurrentBelow: {
+            const CellSignal signal = step.kind == StepKind::WaitCurrentBelow ? CellSignal::Current : CellSignal::Voltage;
+            const char* signalName = signal == CellSignal::Current ? "current" : "voltage";
+            const SignalValue sample = store_.read(test.bench, test.cell, signal);
+            // Only samples taken after the step began (or resumed) count
+            if (sample.timeUs > test.samplesFromUs) {
+                switch (step.kind) {
+                case StepKind::WaitVoltageAbove: done = sample.value >= step.value; break;
+                case StepKind::WaitVoltageBelow: done = sample.value <= step.value; break;
+                default: done = std::fabs(sample.value) <= step.value; break;
+                }
+                result = sample.value;
+            }
+            if (done) {
+                break;
+            }
+            // The step start (or resume) counts as the last sample, so a
+            // cell gets MeasurementTimeout to report after each of them
+            const std::uint64_t lastUs = std::max(sample.timeUs, test.samplesFromUs);
+            const bool measured = (acquired & (1U << static_cast<unsigned>(signal))) != 0;
+            if (!measured || (nowUs > lastUs && nowUs - lastUs > static_cast<std::uint64_t>(MeasurementTimeout.count()) * 1000)) {
+                power_.outputOff(test.bench, test.cell);
+                notifications.push_back(Notification{
+                    test.onStatus, test.id,
+                    status(test, TestState::Failed,
+                           "Step " + std::to_string(test.current + 1) + ": no " + signalName
+                               + (measured ? " measurement for " + std::to_string(MeasurementTimeout.count()) + " ms"
+                                           : " measurement acquired"))});
+                return false;
+            }
+            if (durationUs != 0 && elapsedUs >= durationUs) {
+                power_.outputOff(test.bench, test.cell);
+                notifications.push_back(Notification{
+                    test.onStatus, test.id,
+                    status(test, TestState::Failed,
+                           "Step " + std::to_string(test.current + 1) + " timed out waiting for " + signalName)});
+                return false;
+            }
+            break;
+        }
+        }
+        if (!done) {
+            return true;
+        }
+        test.result = result;
+        ++test.current;
+        test.entered = false;
+    }
+
+    power_.outputOff(test.bench, test.cell);
+    if (const std::exception_ptr exception = test.procedure.exception()) {
+        std::string message = "Procedure failed";
+        try {
+            std::rethrow_exception(exception);
+        } catch (const std::exception& e) {
+            message += std::string(": ") + e.what();
+        } catch (...) {
+        }
+        notifications.push_back(Notification{test.onStatus, test.id, status(test, TestState::Failed, std::move(message))});
+    } else {
+        notifications.push_back(Notification{test.onStatus, test.id, status(test, TestState::Completed)});
+    }
+    return false;
+}
+
+bool TestStepEngine::applyRequests(RunningTest& test, std::uint64_t nowUs, std::vector<Notification>& notifications) {
+    if (test.cancellation.isCancelled()) {
+        power_.outputOff(test.bench, test.cell);
+        notifications.push_back(Notification{test.onStatus, test.id, status(test, TestState::Cancelled)});
+        return false;
+    }
+    if (test.pauseRequested == test.paused) {
+        return true;
+    }
+
+    test.paused = test.pauseRequested;
+    if (test.paused) {
+        power_.outputOff(test.bench, test.cell);
+        test.pausedAtUs = nowUs;
+    } else {
+        // The step keeps the time it had left; samples from the paused
+        // (unpowered) cell must not satisfy its wait condition
+        test.stepStartUs += nowUs - test.pausedAtUs;
+        test.samplesFromUs = nowUs;
+        if (test.entered && test.setpoint) {
+            applySetpoint(test, *test.setpoint);
+        }
+    }
+    notifications.push_back(
+        Notification{test.onStatus, test.id, status(test, test.paused ? TestState::Paused : TestState::Running)});
+    return true;
+}
+
+bool TestStepEngine::enterStep(RunningTest& test, std::uint64_t nowUs) {
+    std::optional<TestStep> step = test.procedure.next(test.result);
+    if (!step) {
+        return false;
+    }
+    test.step = *step;
+    switch (test.step.kind) {
+    case StepKind::SetCurrent:
+    case StepKind::SetVoltage:
+        applySetpoint(test, test.step);
+        test.setpoint = test.step;
+        break;
+    case StepKind::Rest:
+        power_.outputOff(test.bench, test.cell);
+        test.setpoint.reset();
+        break;
+    default:
+        break;
+    }
+    test.entered = true;
+    test.stepStartUs = nowUs;
+    test.samplesFromUs = nowUs;
+    return true;
+}
+
+void TestStepEngine::applySetpoint(const RunningTest& test, const TestStep& step) {
+    if (step.kind == StepKind::SetCurrent) {
+        power_.setCurrent(test.bench, test.cell, step.value);
+    } else {
+        power_.setVoltage(test.bench, test.cell, step.value);
+    }
+}
+
+TestStatus TestStepEngine::status(const RunningTest& test, TestState state, std::string message) {
+    return TestStatus{state, test.current, test.plannedSteps, std::move(message)};
+}
+
+void TestStepEngine::engineLoop() {
+    // Fixed-rate schedule: a slow period does not push back the following ones
+    auto next = std::chrono::steady_clock::now();
+    while (running_.load()) {
+        poll(monotonicMicros());
+        next += ControlPeriod;
+        const auto now = std::chrono::steady_clock::now();
+        if (next < now) {
+            next = now;
+        }
+        std::this_thread::sleep_until(next);
+    }
+}
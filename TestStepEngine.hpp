@@ -0,0 +1,169 @@
+#ifndef TESTSTEPENGINE_HPP
+#define TESTSTEPENGINE_HPP
+
+#include "BenchExecutor.hpp"
+#include "CancellationToken.hpp"
+#include "TestProcedure.hpp"
+#include "signal_store.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Hardware side of a test: whatever drives the cell's power stage
+class CellPowerControl {
+public:
+    virtual ~CellPowerControl() = default;
+    virtual void setCurrent(std::size_t bench, std::size_t cell, double amps) = 0;  // > 0 charges
+    virtual void setVoltage(std::size_t bench, std::size_t cell, double volts) = 0; // Constant-voltage mode
+    virtual void outputOff(std::size_t bench, std::size_t cell) = 0;                // Safe state
+};
+
+enum class TestState {
+    Running,
+    Paused,     // Output off and step timers stopped until resumed
+    Completed,
+    Failed,
+    Cancelled   // Stopped on request; the output is off
+};
+
+struct TestStatus {
+    TestState state;
+    std::size_t stepIndex;   // Step being executed; number of steps run once completed
+    std::size_t stepCount;   // Planned steps, 0 if the procedure did not say
+    std::string message;     // Reason, for failures
+};
+
+using TestId = std::uint32_t;
+constexpr TestId InvalidTestId = 0;
+
+// Runs the procedures of any number of cell tests. Every test is a small
+// state machine around its procedure coroutine: each control period the
+// engine enters due steps, checks wait conditions against the newest samples
+// in the signal store and advances timers, resuming the procedure whenever a
+// step is done. Nothing ever blocks, so thousands of tests share the engine's
+// threads, and a step transition follows the sample that triggered it within
+// one control period.
+//
+// Tests are kept per bench. The engine thread only keeps time; each period
+// it hands every bench with running tests to the executor as one job, so
+// large racks are supervised on all cores and benches never wait on each
+// other's locks.
+//
+// Tests only run on cells whose signals are acquired (setAcquired). A wait
+// step fails the test when its signal is not acquired or has not been
+// updated for MeasurementTimeout, so a lost channel never leaves a power
+// stage running towards a threshold it cannot see.
+//
+// Outputs are switched off whenever a test completes, fails, is cancelled or
+// paused, and for all running tests when the engine is destroyed. Cancel and
+// pause requests are picked up at the start of the test's next period, so
+// they take effect within one ControlPeriod.
+class TestStepEngine {
+public:
+    static constexpr std::chrono::milliseconds ControlPeriod{5};
+    static constexpr std::chrono::milliseconds MeasurementTimeout = 20 * ControlPeriod;
+
+    // Called on an executor thread whenever a test enters a step, is paused or
+    // resumed, or finishes
+    using StatusCallback = std::function<void(TestId, const TestStatus&)>;
+
+    // executor must outlive the engine
+    TestStepEngine(const SignalStore& store, CellPowerControl& power, BenchExecutor& executor);
+    ~TestStepEngine();
+
+    TestStepEngine(const TestStepEngine&) = delete;
+    TestStepEngine& operator=(const TestStepEngine&) = delete;
+
+    // Marks a signal of a cell as written to the store by a running
+    // acquisition, or no longer written
+    void setAcquired(std::size_t bench, std::size_t cell, CellSignal signal, bool acquired = true);
+    // True if any signal of the cell is acquired
+    bool isMeasured(std::size_t bench, std::size_t cell) const;
+
+    // Returns InvalidTestId if the cell already runs a test or is not
+    // measured, see setAcquired. Cancelling the
+    // token ends the test with TestState::Cancelled. plannedSteps only feeds
+    // TestStatus::stepCount for progress display.
+    TestId startTest(std::size_t bench, std::size_t cell, TestProcedure procedure, StatusCallback onStatus,
+                     CancellationToken cancellation = {}, std::size_t plannedSteps = 0);
+    // Runs a fixed step list
+    TestId startTest(std::size_t bench, std::size_t cell, std::vector<TestStep> steps, StatusCallback onStatus,
+                     CancellationToken cancellation = {});
+
+    // Switches the test's output off and freezes its step timers; resumeTest
+    // restores the setpoint that was active and carries on with the same
+    // step. Both return false if id is not running.
+    bool pauseTest(TestId id);
+    bool resumeTest(TestId id);
+
+    std::size_t activeTestCount() const;
+
+    // Advances every test to nowUs and returns once all benches are done;
+    // the engine thread calls this once per control period
+    void poll(std::uint64_t nowUs);
+
+private:
+    struct RunningTest {
+        TestId id;
+        std::size_t bench;
+        std::size_t cell;
+        TestProcedure procedure;
+        std::size_t plannedSteps = 0;
+        StatusCallback onStatus;
+        CancellationToken cancellation;
+        TestStep step{StepKind::Hold};        // Step in progress, valid while entered
+        std::size_t current = 0;              // Steps taken from the procedure so far
+        bool entered = false;
+        double result = 0.0;                  // Value of the procedure's last co_await
+        std::uint64_t stepStartUs = 0;
+        std::uint64_t samplesFromUs = 0;      // Waits only count samples taken after this
+        std::optional<TestStep> setpoint;     // Setpoint step in force, restored on resume
+        bool pauseRequested = false;
+        bool paused = false;
+        std::uint64_t pausedAtUs = 0;
+    };
+
+    struct Notification {
+        StatusCallback callback;
+        TestId id;
+        TestStatus status;
+    };
+
+    struct BenchTests {
+        mutable std::mutex mutex_;       // Guards tests_ and acquired_
+        std::vector<RunningTest> tests_;
+        std::vector<std::uint8_t> acquired_;  // Per cell, bit per CellSignal
+    };
+
+    bool requestPause(TestId id, bool pause);
+    void pollBench(BenchTests& bench, std::uint64_t nowUs);
+    // Returns false once the test has finished (completed or failed).
+    // acquired is the cell's entry of BenchTests::acquired_.
+    bool advance(RunningTest& test, std::uint8_t acquired, std::uint64_t nowUs, std::vector<Notification>& notifications);
+    // Returns false if the test was cancelled
+    bool applyRequests(RunningTest& test, std::uint64_t nowUs, std::vector<Notification>& notifications);
+    // Takes the procedure's next step; returns false once it has none left
+    bool enterStep(RunningTest& test, std::uint64_t nowUs);
+    void applySetpoint(const RunningTest& test, const TestStep& step);
+    static TestStatus status(const RunningTest& test, TestState state, std::string message = {});
+    void engineLoop();
+
+    const SignalStore& store_;
+    CellPowerControl& power_;
+    BenchExecutor& executor_;
+
+    std::vector<std::unique_ptr<BenchTests>> benches_;
+    std::atomic<TestId> nextId_{1};
+
+    std::atomic<bool> running_{true};
+    std::thread thread_;
+};
+
+#endif // TESTSTEPENGINE_HPP
@@ -0,0 +1,196 @@
+#include "bench_acquisition.hpp"
+#include <algorithm>
+
+BenchAcquisition::BenchAcquisition(CANChannelManager& channels, std::size_t bench, const SignalDecoder& decoder, SignalStore& store)
+    : m_channels(channels),
+      m_bench(bench),
+      m_decoder(decoder),
+      m_store(store),
+      m_routes(decoder.signalCount(), Route{Unmapped, Unmapped}),
+      m_filter(decoder.signalCount()) {}
+
+BenchAcquisition::~BenchAcquisition() {
+    stop();
+}
+
+bool BenchAcquisition::mapSignal(std::uint32_t signalId, std::size_t cell, CellSignal signal) {
+    // The store is indexed without bounds checks on the acquisition path
+    if (signalId >= m_routes.size() || cell >= m_store.cellCount()
+        || static_cast<std::size_t>(signal) >= m_store.signalCount()) {
+        return false;
+    }
+    m_routes[signalId] = Route{static_cast<std::uint32_t>(cell), static_cast<std::uint32_t>(signal)};
+    return true;
+}
+
+std::size_t BenchAcquisition::enableCellFrameDecoding(const DBCDatabase& database) {
+    for (const DBCMessage& message : database.messages) {
+        CellFrameLayout layout;
+        const bool multiplexed = std::any_of(message.signals.begin(), message.signals.end(), [](const DBCSignal& signal) {
+            return signal.isMultiplexor || signal.isMultiplexed;
+        });
+        if (multiplexed || !cellLayoutFromMessage(message, layout)) {
+            continue;
+        }
+
+        // Same order as the layout's cells
+        std::vector<const DBCSignal*> cells;
+        for (const DBCSignal& signal : message.signals) {
+            cells.push_back(&signal);
+        }
+        std::sort(cells.begin(), cells.end(), [](const DBCSignal* a, const DBCSignal* b) { return a->startBit < b->startBit; });
+
+        CellFrameRoute route(layout);
+        std::vector<std::uint32_t> mapped;  // Layout cells with a route
+        for (const DBCSignal* signal : cells) {
+            const std::uint32_t signalId = m_decoder.findSignalId(message.name, signal->name);
+            if (signalId >= m_routes.size()) {
+                break;  // Not compiled by the decoder (invalid ID)
+            }
+            if (m_routes[signalId].cell != Unmapped) {
+                mapped.push_back(static_cast<std::uint32_t>(route.signalIds.size()));
+            }
+            route.signalIds.push_back(signalId);
+        }
+        if (route.signalIds.size() != cells.size() || mapped.empty() || !route.decoder.isValid()) {
+            continue;
+        }
+
+        std::stable_sort(mapped.begin(), mapped.end(), [&](std::uint32_t a, std::uint32_t b) {
+            return m_routes[route.signalIds[a]].cell < m_routes[route.signalIds[b]].cell;
+        });
+        for (const std::uint32_t layoutCell : mapped) {
+            const Route target = m_routes[route.signalIds[layoutCell]];
+            if (route.writes.empty() || route.writes.back().cell != target.cell) {
+                route.writes.push_back({target.cell, static_cast<std::uint32_t>(route.cellSignals.size()), 0});
+            }
+            ++route.writes.back().count;
+            route.cellSignals.push_back(target.signal);
+            route.layoutCells.push_back(layoutCell);
+        }
+        route.newest.resize(route.cellSignals.size());
+        route.frames.reserve(FrameBatchSize);
+        route.timesUs.reserve(FrameBatchSize);
+        route.values.resize(cells.size() * FrameBatchSize);
+
+        m_cellFrameIndex[message.dbcId()] = m_cellFrames.size();
+        m_cellFrames.push_back(std::move(route));
+    }
+    return m_cellFrames.size();
+}
+
+void BenchAcquisition::setFilter(std::uint32_t signalId, const SignalFilterConfig& config) {
+    m_filter.configure(signalId, config);
+}
+
+void BenchAcquisition::start() {
+    if (m_running.exchange(true)) {
+        return;
+    }
+    m_thread = std::thread(&BenchAcquisition::acquisitionLoop, this);
+}
+
+void BenchAcquisition::stop() {
+    if (!m_running.exchange(false)) {
+        return;
+    }
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void BenchAcquisition::acquisitionLoop() {
+    std::vector<ChannelFrame> frames(FrameBatchSize);
+    std::vector<DecodedSignal> values(std::max(m_decoder.maxSignalsPerMessage(), std::size_t{1}));
+
+    while (m_running.load(std::memory_order_relaxed)) {
+        const std::size_t frameCount = m_channels.readBenchFrames(m_bench, frames.data(), frames.size(), WaitMs);
+        for (std::size_t i = 0; i < frameCount; ++i) {
+            const CANFrameFD& frame = frames[i].frame;
+            if (m_timeoutMonitor != nullptr) {
+                m_timeoutMonitor->frameReceived(frame.message.ID, (frame.message.MSGTYPE & PCAN_MESSAGE_EXTENDED) != 0,
+                                                frame.hostTimeUs);
+            }
+            if (collectCellFrame(frame, values)) {
+                continue;
+            }
+            const std::size_t valueCount = m_decoder.decode(frame.message, values.data());
+            // Unfiltered: readers judge freshness by the store's timestamps
+            for (std::size_t v = 0; v < valueCount; ++v) {
+                const Route route = m_routes[values[v].signalId];
+                if (route.cell != Unmapped) {
+                    m_store.write(m_bench, route.cell, route.signal, values[v].value, frame.hostTimeUs);
+                }
+            }
+            notifyListener(values.data(), valueCount, frame.hostTimeUs);
+        }
+        for (CellFrameRoute& route : m_cellFrames) {
+            decodeCellFrames(route, values);
+        }
+    }
+}
+
+bool BenchAcquisition::collectCellFrame(const CANFrameFD& frame, std::vector<DecodedSignal>& samples) {
+    if (m_cellFrames.empty() || (frame.message.MSGTYPE & PCAN_MESSAGE_RTR) != 0) {
+        return false;
+    }
+    const bool extended = (frame.message.MSGTYPE & PCAN_MESSAGE_EXTENDED) != 0;
+    const auto found = m_cellFrameIndex.find(extended ? (frame.message.ID | 0x80000000U) : frame.message.ID);
+    if (found == m_cellFrameIndex.end()) {
+        return false;
+    }
+    CellFrameRoute& route = m_cellFrames[found->second];
+    if (canFdDlcToLength(frame.message.DLC) < route.decoder.layout().frameBytes) {
+        // Short frame: the per-signal decoder only extracts what is there,
+        // after the frames that came before it
+        decodeCellFrames(route, samples);
+        return false;
+    }
+    route.frames.push_back(frame.message);
+    route.timesUs.push_back(frame.hostTimeUs);
+    return true;
+}
+
+void BenchAcquisition::decodeCellFrames(CellFrameRoute& route, std::vector<DecodedSignal>& samples) {
+    const std::size_t frameCount = route.frames.size();
+    if (frameCount == 0) {
+        return;
+    }
+    route.decoder.decode(route.frames.data(), frameCount, route.values.data(), frameCount);
+
+    // The store keeps only the newest sample, so only the last frame is written
+    const std::uint64_t newestUs = route.timesUs[frameCount - 1];
+    for (std::size_t i = 0; i < route.layoutCells.size(); ++i) {
+        route.newest[i] = route.values[route.layoutCells[i] * frameCount + frameCount - 1];
+    }
+    for (const CellFrameRoute::CellWrite& write : route.writes) {
+        m_store.writeCell(m_bench, write.cell, &route.cellSignals[write.first], &route.newest[write.first], write.count,
+                          newestUs);
+    }
+
+    if (m_listener) {
+        samples.resize(std::max(samples.size(), route.layoutCells.size()));
+        for (std::size_t frame = 0; frame < frameCount; ++frame) {
+            for (std::size_t i = 0; i < route.layoutCells.size(); ++i) {
+                const std::uint32_t layoutCell = route.layoutCells[i];
+                samples[i] = DecodedSignal{route.signalIds[layoutCell], route.values[layoutCell * frameCount + frame]};
+            }
+            notifyListener(samples.data(), route.layoutCells.size(), route.timesUs[frame]);
+        }
+    }
+    route.frames.clear();
+    route.timesUs.clear();
+}
+
+void BenchAcquisition::notifyListener(DecodedSignal* samples, std::size_t count, std::uint64_t timeUs) {
+    if (!m_listener) {
+        return;
+    }
+    count = m_filter.filter(samples, count, timeUs);
+    for (std::size_t i = 0; i < count; ++i) {
+        const Route route = m_routes[samples[i].signalId];
+        if (route.cell != Unmapped) {
+            m_listener(route.cell, static_cast<CellSignal>(route.signal), samples[i].value, timeUs);
+        }
+    }
+}
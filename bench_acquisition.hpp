@@ -0,0 +1,117 @@
+#ifndef BENCH_ACQUISITION_HPP
+#define BENCH_ACQUISITION_HPP
+
+#include "can_channel_manager.hpp"
+#include "cell_voltage_decoder.hpp"
+#include "rx_timeout_monitor.hpp"
+#include "signal_decoder.hpp"
+#include "signal_filter.hpp"
+#include "signal_store.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Acquisition thread for one bench: takes the bench's frames from the
+// channel manager, decodes them and publishes every sample of the mapped
+// signals to the signal store, which always holds the newest value and
+// time. It is the single writer for the bench's cells.
+//
+// The change filter only thins out the fan-out to the sample listener (UI
+// updates, logging): samples inside their signal's deadband never reach it.
+//
+// Messages of packed cell values (see cellLayoutFromMessage) can be
+// switched to CellVoltageDecoder: their frames are collected per read batch
+// and decoded for all cells at once, and each cell's newest value goes to
+// the store in one update.
+class BenchAcquisition {
+public:
+    // Called on the acquisition thread for every mapped sample that passes the filter
+    using SampleListener = std::function<void(std::size_t cell, CellSignal signal, double value, std::uint64_t timeUs)>;
+
+    BenchAcquisition(CANChannelManager& channels, std::size_t bench, const SignalDecoder& decoder, SignalStore& store);
+    ~BenchAcquisition();
+
+    BenchAcquisition(const BenchAcquisition&) = delete;
+    BenchAcquisition& operator=(const BenchAcquisition&) = delete;
+
+    // Publishes decoder signal signalId as (cell, signal) of this bench.
+    // Returns false, mapping nothing, if signalId or cell is out of range.
+    // Only valid before start().
+    bool mapSignal(std::uint32_t signalId, std::size_t cell, CellSignal signal);
+
+    // Switches every message of database that is one packed cell layout with
+    // at least one mapped signal to batch decoding. database must be the one
+    // the decoder was built from. Call after mapSignal(), before start().
+    // Returns the number of messages switched.
+    std::size_t enableCellFrameDecoding(const DBCDatabase& database);
+
+    // Deadband/min-interval for one signal's listener updates; unconfigured
+    // signals pass through unfiltered. Only valid before start().
+    void setFilter(std::uint32_t signalId, const SignalFilterConfig& config);
+
+    // Only valid before start()
+    void setSampleListener(SampleListener listener) { m_listener = std::move(listener); }
+
+    // Reports every received frame to monitor (may be nullptr); the monitor
+    // must outlive the acquisition. Only valid before start().
+    void setTimeoutMonitor(RxTimeoutMonitor* monitor) { m_timeoutMonitor = monitor; }
+
+    void start();
+    void stop();
+
+private:
+    struct Route {
+        std::uint32_t cell;
+        std::uint32_t signal;
+    };
+
+    static constexpr std::uint32_t Unmapped = UINT32_MAX;
+    static constexpr std::size_t FrameBatchSize = 256;
+    static constexpr unsigned int WaitMs = 50;  // Bounds how long stop() waits
+
+    // Frames of one batch-decoded message
+    struct CellFrameRoute {
+        explicit CellFrameRoute(const CellFrameLayout& layout) : decoder(layout) {}
+
+        CellVoltageDecoder decoder;
+        std::vector<std::uint32_t> signalIds;  // Per layout cell, in start-bit order
+        // Store updates, grouped by cell: cellSignals/layoutCells[first, first + count)
+        struct CellWrite {
+            std::uint32_t cell;
+            std::uint32_t first;
+            std::uint32_t count;
+        };
+        std::vector<CellWrite> writes;
+        std::vector<std::size_t> cellSignals;
+        std::vector<std::uint32_t> layoutCells;
+        std::vector<double> newest;            // Staging for writeCell, parallel to cellSignals
+        std::vector<TPCANMsgFD> frames;        // Collected during one read batch
+        std::vector<std::uint64_t> timesUs;
+        std::vector<float> values;             // SoA decoder output, layout cell * frames.size() + frame
+    };
+
+    void acquisitionLoop();
+    // Returns false if the frame takes the per-signal path
+    bool collectCellFrame(const CANFrameFD& frame, std::vector<DecodedSignal>& samples);
+    void decodeCellFrames(CellFrameRoute& route, std::vector<DecodedSignal>& samples);
+    void notifyListener(DecodedSignal* samples, std::size_t count, std::uint64_t timeUs);
+
+    CANChannelManager& m_channels;
+    std::size_t m_bench;
+    const SignalDecoder& m_decoder;
+    SignalStore& m_store;
+    std::vector<Route> m_routes;  // Indexed by decoder signal ID
+    std::vector<CellFrameRoute> m_cellFrames;
+    std::unordered_map<std::uint32_t, std::size_t> m_cellFrameIndex;  // dbcId() -> m_cellFrames
+    SignalChangeFilter m_filter;
+    SampleListener m_listener;
+    RxTimeoutMonitor* m_timeoutMonitor = nullptr;
+
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+};
+
+#endif // BENCH_ACQUISITION_HPP
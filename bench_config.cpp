@@ -0,0 +1,199 @@
+#include "bench_config.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#ifdef _WIN32
+#include "pcan_transport.hpp"
+#elif defined(__linux__)
+#include "socketcan_transport.hpp"
+#endif
+
+namespace {
+
+std::string trim(const std::string& text) {
+    const std::size_t first = text.find_first_not_of(" \t\r");
+    if (first == std::string::npos) {
+        return {};
+    }
+    const std::size_t last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+void replaceAll(std::string& text, const std::string& placeholder, const std::string& value) {
+    for (std::size_t pos = text.find(placeholder); pos != std::string::npos;
+         pos = text.find(placeholder, pos + value.size())) {
+        text.replace(pos, placeholder.size(), value);
+    }
+}
+
+// "bench<N>.channel" -> zero-based N, or -1
+long benchKeyIndex(const std::string& key) {
+    static const std::string Prefix = "bench";
+    static const std::string Suffix = ".channel";
+    if (key.size() <= Prefix.size() + Suffix.size() || key.compare(0, Prefix.size(), Prefix) != 0
+        || key.compare(key.size() - Suffix.size(), Suffix.size(), Suffix) != 0) {
+        return -1;
+    }
+    const std::string number = key.substr(Prefix.size(), key.size() - Prefix.size() - Suffix.size());
+    char* end = nullptr;
+    const long bench = std::strtol(number.c_str(), &end, 10);
+    return (end != number.c_str() && *end == '\0' && bench >= 1) ? bench - 1 : -1;
+}
+
+// "voltage" -> CellSignal index, or -1
+long signalKeyIndex(const std::string& name) {
+    static const char* const Names[] = {"voltage", "temperature", "current"};
+    static_assert(sizeof(Names) / sizeof(Names[0]) == static_cast<std::size_t>(CellSignal::Count), "one name per CellSignal");
+    for (std::size_t i = 0; i < static_cast<std::size_t>(CellSignal::Count); ++i) {
+        if (name == Names[i]) {
+            return static_cast<long>(i);
+        }
+    }
+    return -1;
+}
+
+bool parseNonNegative(const std::string& text, double& value) {
+    char* end = nullptr;
+    value = std::strtod(text.c_str(), &end);
+    return end != text.c_str() && *end == '\0' && value >= 0.0;
+}
+
+// "<signal>.deadband|min_interval_ms|max_interval_ms" into filters
+bool applyFilterKey(const std::string& key, const std::string& value, SignalFilterConfig* filters, std::string& reason) {
+    const std::size_t dot = key.find('.');
+    const long signal = dot == std::string::npos ? -1 : signalKeyIndex(key.substr(0, dot));
+    if (signal < 0) {
+        reason = "unknown key '" + key + "'";
+        return false;
+    }
+    const std::string setting = key.substr(dot + 1);
+    double number = 0.0;
+    if (!parseNonNegative(value, number)) {
+        reason = "'" + key + "' needs a non-negative number";
+        return false;
+    }
+    SignalFilterConfig& filter = filters[signal];
+    if (setting == "deadband") {
+        filter.deadband = number;
+    } else if (setting == "min_interval_ms") {
+        filter.minIntervalUs = static_cast<std::uint64_t>(number * 1000.0);
+    } else if (setting == "max_interval_ms") {
+        filter.maxIntervalUs = static_cast<std::uint64_t>(number * 1000.0);
+    } else {
+        reason = "unknown key '" + key + "'";
+        return false;
+    }
+    // Any filter key turns the pass-through default into "forward changes only"
+    filter.deadband = std::max(filter.deadband, 0.0);
+    return true;
+}
+
+} // namespace
+
+bool loadBenchConfig(const std::string& path, BenchConfig& config, std::string* error) {
+    config = BenchConfig();
+    std::ifstream input(path);
+    if (!input) {
+        if (error != nullptr) {
+            *error = "cannot open " + path;
+        }
+        return false;
+    }
+
+    BenchConfig parsed;
+    std::string line;
+    for (std::size_t lineNumber = 1; std::getline(input, line); ++lineNumber) {
+        const std::size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.erase(comment);
+        }
+        line = trim(line);
+        if (line.empty()) {
+            continue;
+        }
+        const std::size_t equals = line.find('=');
+        const std::string key = trim(line.substr(0, equals));
+        const std::string value = equals == std::string::npos ? std::string() : trim(line.substr(equals + 1));
+        if (equals == std::string::npos || key.empty() || value.empty()) {
+            if (error != nullptr) {
+                *error = "line " + std::to_string(lineNumber) + ": expected key = value";
+            }
+            return false;
+        }
+
+        if (key == "dbc") {
+            // Relative to the config file, so a config directory can be moved as a whole
+            const std::size_t slash = path.find_last_of("/\\");
+            const bool absolute = value[0] == '/' || value[0] == '\\' || value.find(':') != std::string::npos;
+            parsed.dbcPath = (absolute || slash == std::string::npos) ? value : path.substr(0, slash + 1) + value;
+        } else if (key == "node") {
+            parsed.node = value;
+        } else if (key == "setpoint.mode") {
+            parsed.setpointModePattern = value;
+        } else if (key == "setpoint.value") {
+            parsed.setpointValuePattern = value;
+        } else if (const long signal = signalKeyIndex(key); signal >= 0) {
+            parsed.signalPatterns[signal] = value;
+        } else if (const long bench = benchKeyIndex(key); bench >= 0) {
+            if (parsed.channels.size() <= static_cast<std::size_t>(bench)) {
+                parsed.channels.resize(static_cast<std::size_t>(bench) + 1);
+            }
+            parsed.channels[static_cast<std::size_t>(bench)] = value;
+        } else if (std::string reason; !applyFilterKey(key, value, parsed.signalFilters, reason)) {
+            if (error != nullptr) {
+                *error = "line " + std::to_string(lineNumber) + ": " + reason;
+            }
+            return false;
+        }
+    }
+
+    if (parsed.dbcPath.empty()) {
+        if (error != nullptr) {
+            *error = "no dbc given";
+        }
+        return false;
+    }
+    config = std::move(parsed);
+    return true;
+}
+
+bool expandSignalPattern(const std::string& pattern, std::size_t bench, std::size_t cell,
+                         std::string& messageName, std::string& signalName) {
+    std::string name = pattern;
+    replaceAll(name, "{bench}", std::to_string(bench + 1));
+    replaceAll(name, "{cell}", std::to_string(cell + 1));
+    const std::size_t dot = name.find('.');
+    if (dot == std::string::npos || dot == 0 || dot + 1 == name.size()) {
+        return false;
+    }
+    messageName = name.substr(0, dot);
+    signalName = name.substr(dot + 1);
+    return true;
+}
+
+std::unique_ptr<CANInterface> openBenchChannel(const std::string& spec, TPCANBaudrate baudrate) {
+    const std::size_t colon = spec.find(':');
+    const std::string backend = spec.substr(0, colon);
+    const std::string name = colon == std::string::npos ? std::string() : spec.substr(colon + 1);
+
+    std::unique_ptr<CANTransport> transport;
+#ifdef _WIN32
+    if (backend == "pcan" && !name.empty()) {
+        transport = std::make_unique<PCANTransport>(static_cast<TPCANHandle>(std::strtoul(name.c_str(), nullptr, 0)));
+    }
+#elif defined(__linux__)
+    if (backend == "socketcan" && !name.empty()) {
+        transport = std::make_unique<SocketCANTransport>(name);
+    }
+#endif
+    if (!transport) {
+        std::cerr << "Opening CAN channel " << spec << " failed! Backend not available on this platform" << std::endl;
+        return nullptr;
+    }
+    auto can = std::make_unique<CANInterface>(std::move(transport), baudrate);
+    if (!can->isInitialized()) {
+        return nullptr;  // CANInterface already reported the driver error
+    }
+    return can;
+}
@@ -0,0 +1,63 @@
+#ifndef BENCH_CONFIG_HPP
+#define BENCH_CONFIG_HPP
+
+#include "can_interface.hpp"
+#include "signal_filter.hpp"
+#include "signal_store.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+// Hardware wiring of the benches: which CAN channel each bench listens on,
+// which DBC describes the traffic and which DBC signal carries each cell
+// value. Read from a "key = value" text file ('#' starts a comment):
+//
+//   dbc = dbc/cells.dbc                  # Relative to the config file
+//   node = TestBench                     # DBC node this application acts as
+//   voltage = Cell{cell}.Voltage         # Message.Signal, see below
+//   temperature = Cell{cell}.Temperature
+//   current = Cell{cell}.Current
+//   setpoint.mode = StageCmd{cell}.Mode  # Power-stage command, see below
+//   setpoint.value = StageCmd{cell}.Value
+//   temperature.deadband = 0.2           # Change filter for UI/log updates
+//   temperature.min_interval_ms = 100
+//   temperature.max_interval_ms = 5000
+//   bench1.channel = socketcan:can0      # Linux SocketCAN interface
+//   bench2.channel = pcan:0x52           # PEAK channel handle (Windows)
+//
+// In signal patterns {cell} stands for the one-based cell number and
+// {bench} for the one-based bench number. Benches without a channel are
+// not acquired. The setpoint patterns name the signals a cell's power stage
+// is commanded through, both in the same message: the mode signal carries
+// 0 = output off, 1 = constant current, 2 = constant voltage (SetpointMode),
+// the value signal the amps or volts. The cyclic messages node transmits
+// (GenMsgCycleTime) are sent on every wired bench; all other cyclic messages
+// are supervised for receive timeouts. Signals without filter keys are
+// forwarded unfiltered; the filter never holds back the signal store, see
+// BenchAcquisition.
+struct BenchConfig {
+    std::string dbcPath;
+    std::string node;  // Empty = the application sends no cyclic messages
+    std::string signalPatterns[static_cast<std::size_t>(CellSignal::Count)];  // Indexed by CellSignal
+    std::string setpointModePattern;   // Empty = power stages are not commanded
+    std::string setpointValuePattern;
+    SignalFilterConfig signalFilters[static_cast<std::size_t>(CellSignal::Count)] = {
+        {-1.0, 0, 0}, {-1.0, 0, 0}, {-1.0, 0, 0}};  // Indexed by CellSignal, pass-through by default
+    std::vector<std::string> channels;  // Indexed by bench, empty = not wired
+};
+
+// On failure config is left default and error (if given) receives
+// "line N: <reason>" or the reason the file could not be read.
+bool loadBenchConfig(const std::string& path, BenchConfig& config, std::string* error = nullptr);
+
+// Expands a signal pattern for one cell into message and signal name.
+// Returns false if the pattern has no "Message.Signal" form.
+bool expandSignalPattern(const std::string& pattern, std::size_t bench, std::size_t cell,
+                         std::string& messageName, std::string& signalName);
+
+// Opens a channel spec ("socketcan:<interface>" or "pcan:<handle>") as a
+// classic CAN interface. Returns nullptr if the backend is not available on
+// this platform or the channel cannot be initialized.
+std::unique_ptr<CANInterface> openBenchChannel(const std::string& spec, TPCANBaudrate baudrate = PCAN_BAUD_500K);
+
+#endif // BENCH_CONFIG_HPP
@@ -0,0 +1,177 @@
+#include "can_channel_manager.hpp"
+#include "thread_affinity.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#ifdef _WIN32
+#include "pcan_transport.hpp"
+#endif
+
+namespace {
+
+constexpr std::size_t DispatchBatchSize = 256;
+constexpr unsigned int DispatchWaitMs = 50;  // Bounds how long stop() waits for a worker
+
+} // namespace
+
+CANChannelManager::CANChannelManager(std::size_t benchCount, std::size_t benchQueueCapacity) {
+    for (std::size_t i = 0; i < benchCount; ++i) {
+        m_benches.push_back(std::make_unique<BenchQueue>());
+        m_benches.back()->frames.resize(benchQueueCapacity);
+    }
+}
+
+CANChannelManager::~CANChannelManager() {
+    stop();
+}
+
+std::size_t CANChannelManager::addChannel(std::unique_ptr<CANInterface> can, std::size_t bench, int cpu) {
+    if (bench >= m_benches.size()) {
+        std::cerr << "Adding CAN channel failed! Bench " << bench << " does not exist (" << m_benches.size()
+                  << " benches)" << std::endl;
+        return InvalidChannel;
+    }
+    if (cpu < 0) {
+        const unsigned int cpuCount = std::max(1U, std::thread::hardware_concurrency());
+        cpu = static_cast<int>(m_nextCpu++ % cpuCount);
+    }
+    auto channel = std::make_unique<Channel>();
+    channel->can = std::move(can);
+    channel->bench = bench;
+    channel->cpu = cpu;
+    m_channels.push_back(std::move(channel));
+    return m_channels.size() - 1;
+}
+
+#ifdef _WIN32
+std::size_t CANChannelManager::addAttachedPCANChannels(TPCANBaudrate baudrate,
+                                                       const std::function<int(const TPCANChannelInformation&)>& benchForChannel) {
+    std::size_t opened = 0;
+    for (const TPCANChannelInformation& info : PCANTransport::attachedChannels()) {
+        if (info.channel_condition != PCAN_CHANNEL_AVAILABLE) {
+            continue;  // Occupied by another application
+        }
+        const int bench = benchForChannel(info);
+        if (bench < 0) {
+            continue;
+        }
+        auto can = std::make_unique<CANInterface>(info.channel_handle, baudrate);
+        if (!can->isInitialized()) {
+            continue;
+        }
+        if (addChannel(std::move(can), static_cast<std::size_t>(bench)) != InvalidChannel) {
+            ++opened;
+        }
+    }
+    return opened;
+}
+#endif
+
+void CANChannelManager::start() {
+    if (m_running.exchange(true)) {
+        return;
+    }
+    for (std::size_t i = 0; i < m_channels.size(); ++i) {
+        Channel& channel = *m_channels[i];
+        channel.can->startReceiving(CANInterface::DefaultReceiveQueueCapacity, channel.cpu);
+        channel.worker = std::thread(&CANChannelManager::dispatchLoop, this, i);
+    }
+}
+
+void CANChannelManager::stop() {
+    if (!m_running.exchange(false)) {
+        return;
+    }
+    for (auto& channel : m_channels) {
+        if (channel->worker.joinable()) {
+            channel->worker.join();
+        }
+        channel->can->stopReceiving();
+    }
+    for (auto& bench : m_benches) {
+        std::lock_guard<std::mutex> lock(bench->mutex);
+        bench->frameAvailable.notify_all();
+    }
+}
+
+void CANChannelManager::dispatchLoop(std::size_t channelIndex) {
+    Channel& channel = *m_channels[channelIndex];
+    pinCurrentThreadToCpu(static_cast<unsigned int>(channel.cpu));
+    CANInterface& can = *channel.can;
+    const std::uint16_t channelId = static_cast<std::uint16_t>(channelIndex);
+
+    std::vector<ChannelFrame> batch(DispatchBatchSize);
+    std::vector<CANFrame> classic(can.isFDMode() ? 0 : DispatchBatchSize);
+    std::vector<CANFrameFD> fd(can.isFDMode() ? DispatchBatchSize : 0);
+
+    while (m_running.load(std::memory_order_relaxed)) {
+        std::size_t count = 0;
+        if (can.isFDMode()) {
+            // Block for the first frame, then take whatever else is already queued
+            if (!can.waitForCANFrameFD(fd[0], DispatchWaitMs)) {
+                continue;
+            }
+            count = 1 + can.readCANFramesFD(&fd[1], DispatchBatchSize - 1);
+            for (std::size_t i = 0; i < count; ++i) {
+                batch[i].channel = channelId;
+                batch[i].frame = fd[i];
+            }
+        } else {
+            if (!can.waitForCANFrame(classic[0], DispatchWaitMs)) {
+                continue;
+            }
+            count = 1 + can.readCANFrames(&classic[1], DispatchBatchSize - 1);
+            for (std::size_t i = 0; i < count; ++i) {
+                const CANFrame& source = classic[i];
+                CANFrameFD& target = batch[i].frame;
+                batch[i].channel = channelId;
+                target.message.ID = source.message.ID;
+                target.message.MSGTYPE = source.message.MSGTYPE;
+                target.message.DLC = source.message.LEN;
+                std::memcpy(target.message.DATA, source.message.DATA, sizeof(source.message.DATA));
+                target.timestamp = pcanTimestampToMicros(source.timestamp);
+                target.hostTimeUs = source.hostTimeUs;
+            }
+        }
+        pushToBench(channel.bench, batch.data(), count);
+    }
+}
+
+void CANChannelManager::pushToBench(std::size_t benchIndex, const ChannelFrame* frames, std::size_t count) {
+    BenchQueue& bench = *m_benches[benchIndex];
+    {
+        std::lock_guard<std::mutex> lock(bench.mutex);
+        const std::size_t capacity = bench.frames.size();
+        const std::size_t accepted = std::min(count, capacity - bench.count);
+        // Copy in at most two runs: up to the end of the ring, then from its start
+        const std::size_t tail = (bench.head + bench.count) % std::max<std::size_t>(capacity, 1);
+        const std::size_t firstRun = std::min(accepted, capacity - tail);
+        std::copy_n(frames, firstRun, bench.frames.begin() + static_cast<std::ptrdiff_t>(tail));
+        std::copy_n(frames + firstRun, accepted - firstRun, bench.frames.begin());
+        bench.count += accepted;
+        bench.dropped += count - accepted;
+    }
+    bench.frameAvailable.notify_one();
+}
+
+std::size_t CANChannelManager::readBenchFrames(std::size_t benchIndex, ChannelFrame* frames,
+                                               std::size_t maxCount, unsigned int timeoutMs) {
+    BenchQueue& bench = *m_benches[benchIndex];
+    std::unique_lock<std::mutex> lock(bench.mutex);
+    bench.frameAvailable.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this, &bench] {
+        return bench.count > 0 || !m_running.load(std::memory_order_relaxed);
+    });
+    const std::size_t capacity = bench.frames.size();
+    const std::size_t count = std::min(maxCount, bench.count);
+    const std::size_t firstRun = std::min(count, capacity - bench.head);
+    std::copy_n(bench.frames.begin() + static_cast<std::ptrdiff_t>(bench.head), firstRun, frames);
+    std::copy_n(bench.frames.begin(), count - firstRun, frames + firstRun);
+    bench.head = (bench.head + count) % std::max<std::size_t>(capacity, 1);
+    bench.count -= count;
+    return count;
+}
+
+unsigned long long CANChannelManager::droppedBenchFrames(std::size_t bench) const {
+    std::lock_guard<std::mutex> lock(m_benches[bench]->mutex);
+    return m_benches[bench]->dropped;
+}
@@ -0,0 +1,95 @@
+#ifndef CAN_CHANNEL_MANAGER_HPP
+#define CAN_CHANNEL_MANAGER_HPP
+
+#include "can_interface.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A received frame tagged with the manager channel it came from. Classic
+// frames are widened to TPCANMsgFD (MSGTYPE without PCAN_MESSAGE_FD,
+// DLC = LEN) and their timestamp to microseconds, so benches fed by
+// classic and FD channels see one frame type.
+struct ChannelFrame {
+    std::uint16_t channel;
+    CANFrameFD frame;
+};
+
+// Owns one CANInterface per CAN channel and fans their receive streams
+// into per-bench queues.
+//
+// Every channel gets its own receive engine and its own dispatch worker,
+// both pinned to the same CPU, so adding channels adds independent
+// pipelines instead of contending for a shared thread or lock. Each bench
+// queue is only touched once per received batch.
+class CANChannelManager {
+public:
+    static constexpr std::size_t DefaultBenchQueueCapacity = 65536;
+    static constexpr std::size_t InvalidChannel = static_cast<std::size_t>(-1);
+
+    explicit CANChannelManager(std::size_t benchCount,
+                               std::size_t benchQueueCapacity = DefaultBenchQueueCapacity);
+    ~CANChannelManager();
+
+    CANChannelManager(const CANChannelManager&) = delete;
+    CANChannelManager& operator=(const CANChannelManager&) = delete;
+
+    // Adds an initialized interface whose frames go to bench. cpu < 0 picks
+    // CPUs round-robin. Returns the channel index, or InvalidChannel (and
+    // closes can) if bench does not exist. Only valid before start().
+    std::size_t addChannel(std::unique_ptr<CANInterface> can, std::size_t bench, int cpu = -1);
+
+#ifdef _WIN32
+    // Opens every attached PCAN channel that benchForChannel maps to a bench
+    // (a negative result skips the channel). Returns the number opened.
+    std::size_t addAttachedPCANChannels(TPCANBaudrate baudrate,
+                                        const std::function<int(const TPCANChannelInformation&)>& benchForChannel);
+#endif
+
+    void start();
+    void stop();
+
+    std::size_t channelCount() const { return m_channels.size(); }
+    std::size_t benchCount() const { return m_benches.size(); }
+    CANInterface& channel(std::size_t index) { return *m_channels[index]->can; }
+
+    // Consumer side of a bench queue: waits up to timeoutMs for frames and
+    // moves up to maxCount of them into frames. Any number of threads may
+    // call this, but frames of one bench are only ordered for a single consumer.
+    std::size_t readBenchFrames(std::size_t bench, ChannelFrame* frames, std::size_t maxCount, unsigned int timeoutMs);
+
+    unsigned long long droppedBenchFrames(std::size_t bench) const;
+
+private:
+    struct Channel {
+        std::unique_ptr<CANInterface> can;
+        std::size_t bench;
+        int cpu;
+        std::thread worker;
+    };
+
+    // Fixed-capacity ring; frames that do not fit are dropped and counted
+    struct BenchQueue {
+        mutable std::mutex mutex;
+        std::condition_variable frameAvailable;
+        std::vector<ChannelFrame> frames;  // Sized to the queue capacity once
+        std::size_t head = 0;              // Oldest queued frame
+        std::size_t count = 0;
+        unsigned long long dropped = 0;
+    };
+
+    void dispatchLoop(std::size_t channelIndex);
+    void pushToBench(std::size_t bench, const ChannelFrame* frames, std::size_t count);
+
+    std::vector<std::unique_ptr<Channel>> m_channels;
+    std::vector<std::unique_ptr<BenchQueue>> m_benches;
+    unsigned int m_nextCpu = 0;
+    std::atomic<bool> m_running{false};
+};
+
+#endif // CAN_CHANNEL_MANAGER_HPP
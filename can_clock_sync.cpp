@@ -0,0 +1,70 @@
+#include "can_clock_sync.hpp"
+#include <algorithm>
+
+CANClockSync::CANClockSync(std::uint64_t windowUs) : m_windowUs(windowUs) {}
+
+void CANClockSync::reset() {
+    const std::uint64_t windowUs = m_windowUs;
+    *this = CANClockSync(windowUs);
+}
+
+double CANClockSync::predictedOffset(std::uint64_t hardwareUs) const {
+    return m_refOffset + m_skew * (static_cast<double>(hardwareUs) - static_cast<double>(m_refHardwareUs));
+}
+
+std::uint64_t CANClockSync::toHostTime(std::uint64_t hardwareUs, std::uint64_t hostReadUs) {
+    // A hardware clock jumping back by more than a second means the channel was reset
+    if (m_initialized && hardwareUs + 1000000 < m_lastHardwareUs) {
+        const std::uint64_t lastOutputUs = m_lastOutputUs;
+        reset();
+        m_lastOutputUs = lastOutputUs;
+    }
+
+    const double observedOffset = static_cast<double>(hostReadUs) - static_cast<double>(hardwareUs);
+
+    if (!m_initialized) {
+        m_initialized = true;
+        m_refHardwareUs = hardwareUs;
+        m_refOffset = observedOffset;
+        m_windowStartUs = hardwareUs;
+        m_windowMinHardwareUs = hardwareUs;
+        m_windowMinOffset = observedOffset;
+    }
+
+    // Track the window minimum; close the window once it is long enough
+    if (observedOffset <= m_windowMinOffset) {
+        m_windowMinOffset = observedOffset;
+        m_windowMinHardwareUs = hardwareUs;
+    }
+    if (hardwareUs - m_windowStartUs >= m_windowUs) {
+        if (m_havePreviousWindow && m_windowMinHardwareUs > m_previousMinHardwareUs) {
+            const double measuredSkew = (m_windowMinOffset - m_previousMinOffset) /
+                static_cast<double>(m_windowMinHardwareUs - m_previousMinHardwareUs);
+            const double clamped = std::max(-MaxSkew, std::min(MaxSkew, measuredSkew));
+            m_skew += SkewSmoothing * (clamped - m_skew);
+        }
+        m_havePreviousWindow = true;
+        m_previousMinHardwareUs = m_windowMinHardwareUs;
+        m_previousMinOffset = m_windowMinOffset;
+        m_refHardwareUs = m_windowMinHardwareUs;
+        m_refOffset = m_windowMinOffset;
+
+        m_windowStartUs = hardwareUs;
+        m_windowMinHardwareUs = hardwareUs;
+        m_windowMinOffset = observedOffset;
+    }
+
+    // A frame read sooner than the model predicts tightens the offset right away
+    if (observedOffset < predictedOffset(hardwareUs)) {
+        m_refOffset = observedOffset - m_skew * (static_cast<double>(hardwareUs) - static_cast<double>(m_refHardwareUs));
+    }
+
+    const double mapped = static_cast<double>(hardwareUs) + predictedOffset(hardwareUs);
+    std::uint64_t hostUs = mapped <= 0.0 ? 0 : static_cast<std::uint64_t>(mapped);
+    hostUs = std::min(hostUs, hostReadUs);
+    hostUs = std::max(hostUs, m_lastOutputUs);
+
+    m_lastHardwareUs = hardwareUs;
+    m_lastOutputUs = hostUs;
+    return hostUs;
+}
@@ -0,0 +1,58 @@
+#ifndef CAN_CLOCK_SYNC_HPP
+#define CAN_CLOCK_SYNC_HPP
+
+#include "PCANBasic.h"
+#include <cstdint>
+
+// Total microseconds of a driver timestamp (see TPCANTimestamp in PCANBasic.h)
+inline std::uint64_t pcanTimestampToMicros(const TPCANTimestamp& timestamp) {
+    return timestamp.micros + 1000ULL * timestamp.millis + 0x100000000ULL * 1000ULL * timestamp.millis_overflow;
+}
+
+// Maps the hardware timestamps of one CAN channel onto the host monotonic
+// clock (monotonicMicros()).
+//
+// The host read time of a frame is always later than its true arrival, so
+// the smallest observed (host - hardware) offset is the best estimate of
+// the clock offset. The minimum is tracked per window; comparing successive
+// window minima gives the drift between the adapter's oscillator and the
+// host clock, which is then applied between windows. Mapped times never go
+// backwards and never exceed the host read time.
+class CANClockSync {
+public:
+    explicit CANClockSync(std::uint64_t windowUs = 1000000);
+
+    // Returns hardwareUs expressed on the host timeline. hostReadUs is the
+    // monotonicMicros() value taken when the frame was read from the driver.
+    std::uint64_t toHostTime(std::uint64_t hardwareUs, std::uint64_t hostReadUs);
+
+    void reset();
+    double driftPpm() const { return m_skew * 1e6; }
+
+private:
+    double predictedOffset(std::uint64_t hardwareUs) const;
+
+    static constexpr double MaxSkew = 500e-6;   // Reject drift estimates beyond +/-500 ppm
+    static constexpr double SkewSmoothing = 0.2;
+
+    std::uint64_t m_windowUs;
+    bool m_initialized = false;
+
+    // Current model: offset(hw) = m_refOffset + m_skew * (hw - m_refHardwareUs)
+    std::uint64_t m_refHardwareUs = 0;
+    double m_refOffset = 0.0;
+    double m_skew = 0.0;
+
+    // Lower envelope of the offset within the current window
+    std::uint64_t m_windowStartUs = 0;
+    std::uint64_t m_windowMinHardwareUs = 0;
+    double m_windowMinOffset = 0.0;
+    bool m_havePreviousWindow = false;
+    std::uint64_t m_previousMinHardwareUs = 0;
+    double m_previousMinOffset = 0.0;
+
+    std::uint64_t m_lastHardwareUs = 0;
+    std::uint64_t m_lastOutputUs = 0;
+};
+
+#endif // CAN_CLOCK_SYNC_HPP
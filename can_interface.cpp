@@ -1,24 +1,69 @@
 #include "can_interface.hpp"
+#include "monotonic_clock.hpp"
+#include "thread_affinity.hpp"
 #include <iostream>
-#include "PCANBasic.h"
-#include <windows.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#ifdef _WIN32
+#include "pcan_transport.hpp"
+#endif
 
-CANInterface::CANInterface(TPCANHandle handle) : m_handle(handle) {
-    // Initialize the PCANBasic library for the given CAN handle
-    TPCANStatus status = CAN_Initialize(m_handle, PCAN_BAUD_500K);
+CANInterface::CANInterface(std::unique_ptr<CANTransport> transport, TPCANBaudrate baudrate)
+    : m_transport(std::move(transport)) {
+    TPCANStatus status = m_transport->initialize(baudrate);
     if (status != PCAN_ERROR_OK) {
         std::cerr << "CAN Initialization failed! Error code: " << status << std::endl;
+        return;
     }
+    m_initialized = true;
 }
 
+CANInterface::CANInterface(std::unique_ptr<CANTransport> transport, const std::string& bitrateFD)
+    : m_transport(std::move(transport)), m_fdMode(true) {
+    TPCANStatus status = m_transport->initializeFD(bitrateFD);
+    if (status != PCAN_ERROR_OK) {
+        std::cerr << "CAN FD Initialization failed! Error code: " << status << std::endl;
+        return;
+    }
+    m_initialized = true;
+}
+
+#ifdef _WIN32
+CANInterface::CANInterface(TPCANHandle handle, TPCANBaudrate baudrate)
+    : CANInterface(std::make_unique<PCANTransport>(handle), baudrate) {}
+
+CANInterface::CANInterface(TPCANHandle handle, const std::string& bitrateFD)
+    : CANInterface(std::make_unique<PCANTransport>(handle), bitrateFD) {}
+#endif
+
 CANInterface::~CANInterface() {
-    // Uninitialize the PCANBasic library
-    CAN_Uninitialize(m_handle);
+    stopReceiving();
+    if (m_initialized) {
+        m_transport->uninitialize();
+    }
+}
+
+bool CANInterface::checkMode(bool fdRequired) const {
+    if (m_fdMode != fdRequired) {
+        std::cerr << (fdRequired ? "CAN FD read on a classic CAN channel!" : "Classic CAN read on a CAN FD channel!") << std::endl;
+        return false;
+    }
+    return true;
 }
 
 bool CANInterface::sendCANMessage(TPCANMsg& message) {
-    std::lock_guard<std::mutex> lock(m_mutex);  // Ensure thread safety
-    TPCANStatus status = CAN_Write(m_handle, &message);
+    if (m_fdMode) {
+        // Classic frames are a subset of FD frames; send them without the FD flag
+        TPCANMsgFD messageFD;
+        messageFD.ID = message.ID;
+        messageFD.MSGTYPE = message.MSGTYPE;
+        messageFD.DLC = message.LEN;
+        std::memcpy(messageFD.DATA, message.DATA, sizeof(message.DATA));
+        return sendCANMessageFD(messageFD);
+    }
+    std::lock_guard<std::mutex> lock(m_writeMutex);  // Ensure thread safety
+    TPCANStatus status = m_transport->write(message);
     if (status != PCAN_ERROR_OK) {
         std::cerr << "CAN Write failed! Error code: " << status << std::endl;
         return false;
@@ -26,14 +71,276 @@ bool CANInterface::sendCANMessage(TPCANMsg& message) {
     return true;
 }
 
-bool CANInterface::readCANMessage(TPCANMsg& message) {
-    std::lock_guard<std::mutex> lock(m_mutex);  // Ensure thread safety
-    TPCANStatus status = CAN_Read(m_handle, &message, nullptr);
+bool CANInterface::sendCANMessageFD(TPCANMsgFD& message) {
+    if (!m_fdMode) {
+        std::cerr << "CAN FD write on a classic CAN channel!" << std::endl;
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(m_writeMutex);  // Ensure thread safety
+    TPCANStatus status = m_transport->writeFD(message);
     if (status != PCAN_ERROR_OK) {
-        if (status != PCAN_ERROR_QRCVEMPTY) { // Ignore empty queue errors
+        std::cerr << "CAN FD Write failed! Error code: " << status << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool CANInterface::readCANMessage(TPCANMsg& message) {
+    CANFrame frame;
+    if (!readCANFrame(frame)) {
+        return false;
+    }
+    message = frame.message;
+    return true;
+}
+
+bool CANInterface::readCANFrame(CANFrame& frame) {
+    return readCANFrames(&frame, 1) == 1;
+}
+
+bool CANInterface::readCANFrameFD(CANFrameFD& frame) {
+    return readCANFramesFD(&frame, 1) == 1;
+}
+
+std::size_t CANInterface::readCANMessages(TPCANMsg* messages, TPCANTimestamp* timestamps, std::size_t maxCount) {
+    if (!checkMode(false)) {
+        return 0;
+    }
+    if (!isReceiving()) {
+        std::lock_guard<std::mutex> lock(m_readMutex);  // One lock for the whole batch
+        TPCANStatus status;
+        const std::size_t count = m_transport->readBatch(messages, timestamps, maxCount, status);
+        if (status != PCAN_ERROR_OK && status != PCAN_ERROR_QRCVEMPTY) { // Ignore empty queue errors
             std::cerr << "CAN Read failed! Error code: " << status << std::endl;
         }
+        if (timestamps != nullptr && count > 0) {
+            // Keep the clock model fed even though callers only get raw timestamps here
+            const std::uint64_t hostReadUs = monotonicMicros();
+            for (std::size_t i = 0; i < count; ++i) {
+                m_clockSync.toHostTime(pcanTimestampToMicros(timestamps[i]), hostReadUs);
+            }
+        }
+        return count;
+    }
+
+    // Copy out of the ring in chunks to split frames into the two arrays
+    CANFrame frames[ReceiveBatchSize];
+    std::size_t total = 0;
+    while (total < maxCount) {
+        const std::size_t wanted = std::min(maxCount - total, ReceiveBatchSize);
+        const std::size_t count = m_receiveQueue->popBatch(frames, wanted);
+        for (std::size_t i = 0; i < count; ++i) {
+            messages[total + i] = frames[i].message;
+            if (timestamps != nullptr) {
+                timestamps[total + i] = frames[i].timestamp;
+            }
+        }
+        total += count;
+        if (count < wanted) {
+            break;
+        }
+    }
+    return total;
+}
+
+std::size_t CANInterface::readCANFrames(CANFrame* frames, std::size_t maxCount) {
+    return checkMode(false) ? readFrames(m_receiveQueue, frames, maxCount) : 0;
+}
+
+std::size_t CANInterface::readCANFramesFD(CANFrameFD* frames, std::size_t maxCount) {
+    return checkMode(true) ? readFrames(m_receiveQueueFD, frames, maxCount) : 0;
+}
+
+template <typename Frame>
+std::size_t CANInterface::readFrames(const std::unique_ptr<SpscRingBuffer<Frame>>& queue, Frame* frames,
+                                     std::size_t maxCount) {
+    if (isReceiving()) {
+        return queue->popBatch(frames, maxCount);
+    }
+    std::lock_guard<std::mutex> lock(m_readMutex);  // One lock for the whole batch
+    return drainDriver(frames, maxCount);
+}
+
+bool CANInterface::waitForCANMessage(TPCANMsg& message, unsigned int timeoutMs) {
+    CANFrame frame;
+    if (!waitForCANFrame(frame, timeoutMs)) {
         return false;
     }
+    message = frame.message;
+    return true;
+}
+
+bool CANInterface::waitForCANFrame(CANFrame& frame, unsigned int timeoutMs) {
+    return checkMode(false) && waitForFrame(m_receiveQueue, frame, timeoutMs);
+}
+
+bool CANInterface::waitForCANFrameFD(CANFrameFD& frame, unsigned int timeoutMs) {
+    return checkMode(true) && waitForFrame(m_receiveQueueFD, frame, timeoutMs);
+}
+
+template <typename Frame>
+bool CANInterface::waitForFrame(const std::unique_ptr<SpscRingBuffer<Frame>>& queue, Frame& frame,
+                                unsigned int timeoutMs) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+
+    if (isReceiving()) {
+        if (queue->pop(frame)) {
+            return true;
+        }
+        std::unique_lock<std::mutex> lock(m_consumerMutex);
+        m_consumerWaiting.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);  // Pairs with the fence in notifyConsumer
+        m_frameAvailable.wait_until(lock, deadline, [this, &queue] {
+            return !queue->empty() || !isReceiving();
+        });
+        m_consumerWaiting.store(false, std::memory_order_relaxed);
+        return queue->pop(frame);
+    }
+
+    if (!m_transport->hasReceiveNotification()) {
+        return readFrames(queue, &frame, 1) == 1;
+    }
+    while (true) {
+        if (readFrames(queue, &frame, 1) == 1) {
+            return true;
+        }
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0 ||
+            !m_transport->waitForReceive(static_cast<unsigned int>(remaining.count()))) {
+            return readFrames(queue, &frame, 1) == 1;
+        }
+    }
+}
+
+bool CANInterface::startReceiving(std::size_t queueCapacity, int cpu) {
+    if (isReceiving()) {
+        return true;
+    }
+    if (m_fdMode) {
+        m_receiveQueueFD = std::make_unique<SpscRingBuffer<CANFrameFD>>(queueCapacity);
+    } else {
+        m_receiveQueue = std::make_unique<SpscRingBuffer<CANFrame>>(queueCapacity);
+    }
+    // Publish only once the ring exists: readers that see the flag use it.
+    // The receive thread runs while the flag is set, so it starts afterwards.
+    m_receiving.store(true, std::memory_order_release);
+    m_receiveThread = std::thread([this, cpu] {
+        if (cpu >= 0) {
+            pinCurrentThreadToCpu(static_cast<unsigned int>(cpu));
+        }
+        if (m_fdMode) {
+            receiveLoop(*m_receiveQueueFD);
+        } else {
+            receiveLoop(*m_receiveQueue);
+        }
+    });
     return true;
 }
+
+void CANInterface::stopReceiving() {
+    if (!m_receiving.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+    m_transport->wakeReceiver();  // Wake the receive thread so it sees the stop request
+    notifyConsumer();
+    if (m_receiveThread.joinable()) {
+        m_receiveThread.join();
+    }
+}
+
+template <typename Frame>
+void CANInterface::receiveLoop(SpscRingBuffer<Frame>& queue) {
+    Frame frames[ReceiveBatchSize];
+    while (m_receiving.load(std::memory_order_acquire)) {
+        bool gotFrame = false;
+        // Drain everything the driver has queued before backing off
+        std::size_t count;
+        while (m_receiving.load(std::memory_order_relaxed) &&
+               (count = drainDriver(frames, ReceiveBatchSize)) > 0) {
+            gotFrame = true;
+            for (std::size_t i = 0; i < count; ++i) {
+                if (!queue.push(frames[i])) {
+                    m_droppedFrames.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            if (count < ReceiveBatchSize) {
+                break;
+            }
+        }
+        if (gotFrame) {
+            notifyConsumer();
+        }
+        // Sleep until the transport signals new frames; the timeout only bounds
+        // how long a missed event can delay us. Without notifications, fall back to polling.
+        if (m_transport->hasReceiveNotification()) {
+            m_transport->waitForReceive(50);
+        } else if (!gotFrame) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+}
+
+void CANInterface::notifyConsumer() {
+    // Only pay for the mutex when somebody is actually blocked
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_consumerWaiting.load(std::memory_order_relaxed)) {
+        { std::lock_guard<std::mutex> lock(m_consumerMutex); }
+        m_frameAvailable.notify_one();
+    }
+}
+
+std::size_t CANInterface::drainDriver(CANFrame* frames, std::size_t maxCount) {
+    TPCANMsg messages[ReceiveBatchSize];
+    TPCANTimestamp timestamps[ReceiveBatchSize];
+    // Staged in chunks, until maxCount frames are read or the driver queue runs dry
+    std::size_t total = 0;
+    while (total < maxCount) {
+        const std::size_t wanted = std::min(maxCount - total, ReceiveBatchSize);
+        TPCANStatus status;
+        const std::size_t count = m_transport->readBatch(messages, timestamps, wanted, status);
+        // Report at most one error per batch
+        if (status != PCAN_ERROR_OK && status != PCAN_ERROR_QRCVEMPTY) { // Ignore empty queue errors
+            std::cerr << "CAN Read failed! Error code: " << status << std::endl;
+        }
+
+        // All frames of a batch were read at (roughly) the same host time
+        const std::uint64_t hostReadUs = monotonicMicros();
+        for (std::size_t i = 0; i < count; ++i) {
+            frames[total + i].message = messages[i];
+            frames[total + i].timestamp = timestamps[i];
+            frames[total + i].hostTimeUs = m_clockSync.toHostTime(pcanTimestampToMicros(timestamps[i]), hostReadUs);
+        }
+        total += count;
+        if (count < wanted) {
+            break;
+        }
+    }
+    return total;
+}
+
+std::size_t CANInterface::drainDriver(CANFrameFD* frames, std::size_t maxCount) {
+    TPCANMsgFD messages[ReceiveBatchSize];
+    TPCANTimestampFD timestamps[ReceiveBatchSize];
+    std::size_t total = 0;
+    while (total < maxCount) {
+        const std::size_t wanted = std::min(maxCount - total, ReceiveBatchSize);
+        TPCANStatus status;
+        const std::size_t count = m_transport->readBatchFD(messages, timestamps, wanted, status);
+        if (status != PCAN_ERROR_OK && status != PCAN_ERROR_QRCVEMPTY) { // Ignore empty queue errors
+            std::cerr << "CAN FD Read failed! Error code: " << status << std::endl;
+        }
+
+        const std::uint64_t hostReadUs = monotonicMicros();
+        for (std::size_t i = 0; i < count; ++i) {
+            frames[total + i].message = messages[i];
+            frames[total + i].timestamp = timestamps[i];
+            frames[total + i].hostTimeUs = m_clockSync.toHostTime(timestamps[i], hostReadUs);
+        }
+        total += count;
+        if (count < wanted) {
+            break;
+        }
+    }
+    return total;
+}
@@ -2,21 +2,119 @@
 #define CAN_INTERFACE_HPP
 
 #include "PCANBasic.h"   // Include the PCANBasic library
-#include <windows.h>
+#include "can_transport.hpp"
+#include "spsc_ring_buffer.hpp"
+#include "can_clock_sync.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
 
+// A received CAN frame together with its driver timestamp
+struct CANFrame {
+    TPCANMsg message;
+    TPCANTimestamp timestamp;   // Raw hardware timestamp from the driver
+    std::uint64_t hostTimeUs;   // Hardware timestamp mapped onto monotonicMicros()
+};
+
+// A received CAN FD frame (up to 64 data bytes) together with its driver timestamp
+struct CANFrameFD {
+    TPCANMsgFD message;
+    TPCANTimestampFD timestamp; // Raw hardware timestamp in microseconds
+    std::uint64_t hostTimeUs;   // Hardware timestamp mapped onto monotonicMicros()
+};
+
 class CANInterface {
 public:
-    CANInterface(TPCANHandle handle);
+    static constexpr std::size_t DefaultReceiveQueueCapacity = 8192;
+    static constexpr std::size_t ReceiveBatchSize = 64;
+
+    // 500 kbit/s nominal, 2 Mbit/s data phase on an 80 MHz controller clock
+    static constexpr const char* DefaultFDBitrate =
+        "f_clock_mhz=80,nom_brp=2,nom_tseg1=63,nom_tseg2=16,nom_sjw=16,"
+        "data_brp=2,data_tseg1=15,data_tseg2=4,data_sjw=4";
+
+    // Takes ownership of any backend (PCAN, SocketCAN, virtual bus) and initializes it
+    CANInterface(std::unique_ptr<CANTransport> transport, TPCANBaudrate baudrate = PCAN_BAUD_500K);  // Classic CAN
+    CANInterface(std::unique_ptr<CANTransport> transport, const std::string& bitrateFD);             // CAN FD
+#ifdef _WIN32
+    // Convenience constructors for a PEAK adapter channel
+    CANInterface(TPCANHandle handle, TPCANBaudrate baudrate = PCAN_BAUD_500K);
+    CANInterface(TPCANHandle handle, const std::string& bitrateFD);
+#endif
     ~CANInterface();
 
-    bool sendCANMessage(TPCANMsg& message);  // Function to send CAN messages
+    bool isInitialized() const { return m_initialized; }
+
+    bool isFDMode() const { return m_fdMode; }
+
+    bool sendCANMessage(TPCANMsg& message);  // Function to send CAN messages (also valid in FD mode)
     bool readCANMessage(TPCANMsg& message);  // Function to read CAN messages
+    bool readCANFrame(CANFrame& frame);      // Read a message including its timestamp
+
+    // Batch reads: drain up to maxCount frames with a single lock acquisition
+    // (or a single ring index update when the receive engine runs).
+    // timestamps may be nullptr. Returns the number of frames read.
+    std::size_t readCANMessages(TPCANMsg* messages, TPCANTimestamp* timestamps, std::size_t maxCount);
+    std::size_t readCANFrames(CANFrame* frames, std::size_t maxCount);
+
+    // Blocking reads: sleep on the transport's receive notification (the
+    // driver receive event for PCAN) until a frame arrives or timeoutMs
+    // elapses. Return false on timeout.
+    bool waitForCANMessage(TPCANMsg& message, unsigned int timeoutMs);
+    bool waitForCANFrame(CANFrame& frame, unsigned int timeoutMs);
+
+    // CAN FD counterparts. Only valid on an interface constructed in FD mode;
+    // the classic read functions above are not available in FD mode.
+    bool sendCANMessageFD(TPCANMsgFD& message);
+    bool readCANFrameFD(CANFrameFD& frame);
+    std::size_t readCANFramesFD(CANFrameFD* frames, std::size_t maxCount);
+    bool waitForCANFrameFD(CANFrameFD& frame, unsigned int timeoutMs);
+
+    // Receive engine: a dedicated thread drains the driver queue into a
+    // lock-free ring, so readers never contend with sendCANMessage.
+    // While it runs, readCANMessage/readCANFrame pop from the ring; only
+    // a single consumer thread may read from the interface at a time.
+    // A cpu >= 0 pins the receive thread to that logical CPU.
+    bool startReceiving(std::size_t queueCapacity = DefaultReceiveQueueCapacity, int cpu = -1);
+    void stopReceiving();
+    bool isReceiving() const { return m_receiving.load(std::memory_order_acquire); }
+    unsigned long long droppedFrameCount() const { return m_droppedFrames.load(std::memory_order_relaxed); }
 
 private:
-    TPCANHandle m_handle;         // CAN channel/handle to work with
-    std::mutex m_mutex;           // Mutex for thread safety
+    bool checkMode(bool fdRequired) const;
+    template <typename Frame> void receiveLoop(SpscRingBuffer<Frame>& queue);
+    // queue is only dereferenced after isReceiving() has observed the published ring
+    template <typename Frame>
+    std::size_t readFrames(const std::unique_ptr<SpscRingBuffer<Frame>>& queue, Frame* frames, std::size_t maxCount);
+    template <typename Frame>
+    bool waitForFrame(const std::unique_ptr<SpscRingBuffer<Frame>>& queue, Frame& frame, unsigned int timeoutMs);
+    std::size_t drainDriver(CANFrame* frames, std::size_t maxCount);
+    std::size_t drainDriver(CANFrameFD* frames, std::size_t maxCount);
+    void notifyConsumer();
+
+    std::unique_ptr<CANTransport> m_transport; // Backend doing the actual I/O
+    bool m_fdMode = false;        // Initialized for CAN FD
+    bool m_initialized = false;
+    std::mutex m_writeMutex;      // Serializes transport writes
+    std::mutex m_readMutex;       // Serializes direct transport reads when the receive engine is off
+    CANClockSync m_clockSync;     // Only used by whichever thread currently reads the driver
+
+    std::unique_ptr<SpscRingBuffer<CANFrame>> m_receiveQueue;      // Classic mode
+    std::unique_ptr<SpscRingBuffer<CANFrameFD>> m_receiveQueueFD;  // FD mode
+    std::thread m_receiveThread;
+    std::atomic<bool> m_receiving{false};
+    std::atomic<unsigned long long> m_droppedFrames{0};
+
+    // Wakes a consumer blocked in waitForCANFrame while the engine runs
+    std::mutex m_consumerMutex;
+    std::condition_variable m_frameAvailable;
+    std::atomic<bool> m_consumerWaiting{false};
 };
 
 #endif // CAN_INTERFACE_HPP
@@ -0,0 +1,168 @@
+#include "can_transmit_queue.hpp"
+#include <algorithm>
+#include <cstring>
+
+CANTransmitQueue::CANTransmitQueue(CANInterface& can) : m_can(can) {
+    m_thread = std::thread(&CANTransmitQueue::transmitLoop, this);
+}
+
+CANTransmitQueue::~CANTransmitQueue() {
+    stop();
+}
+
+std::uint32_t CANTransmitQueue::coalescingKey(const TPCANMsgFD& message) {
+    // Standard and extended frames with the same numeric ID are different messages
+    return message.ID | ((message.MSGTYPE & PCAN_MESSAGE_EXTENDED) ? 0x80000000U : 0U);
+}
+
+std::shared_future<bool> CANTransmitQueue::send(const TPCANMsg& message, TxPriority priority) {
+    TPCANMsgFD messageFD;
+    messageFD.ID = message.ID;
+    messageFD.MSGTYPE = message.MSGTYPE;
+    messageFD.DLC = message.LEN;
+    std::memcpy(messageFD.DATA, message.DATA, sizeof(message.DATA));
+    return enqueue(messageFD, false, priority);
+}
+
+std::shared_future<bool> CANTransmitQueue::sendFD(const TPCANMsgFD& message, TxPriority priority) {
+    return enqueue(message, true, priority);
+}
+
+std::shared_future<bool> CANTransmitQueue::enqueue(const TPCANMsgFD& message, bool fd, TxPriority priority) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_stopping) {
+        std::promise<bool> rejected;
+        rejected.set_value(false);
+        return rejected.get_future().share();
+    }
+
+    if (priority == TxPriority::Setpoint) {
+        auto pending = m_pendingSetpoints.find(coalescingKey(message));
+        if (pending != m_pendingSetpoints.end()) {
+            // Supersede the waiting setpoint; it keeps its place in the lane
+            Entry& entry = *pending->second;
+            entry.message = message;
+            entry.fd = fd;
+            ++m_coalesced;
+            return entry.future;
+        }
+    } else {
+        // Sent ahead of the waiting setpoint, which would then undo it
+        // (an emergency stop followed by the old setpoint re-energizes the stage)
+        dropPendingSetpoint(coalescingKey(message));
+    }
+
+    Entry entry;
+    entry.message = message;
+    entry.fd = fd;
+    entry.promise = std::make_shared<std::promise<bool>>();
+    entry.future = entry.promise->get_future().share();
+    std::shared_future<bool> future = entry.future;
+
+    std::deque<Entry>& lane = m_lanes[static_cast<std::size_t>(priority)];
+    lane.push_back(std::move(entry));
+    if (priority == TxPriority::Setpoint) {
+        m_pendingSetpoints[coalescingKey(message)] = &lane.back();
+    }
+    lock.unlock();
+    m_workAvailable.notify_one();
+    return future;
+}
+
+void CANTransmitQueue::dropPendingSetpoint(std::uint32_t key) {
+    auto pending = m_pendingSetpoints.find(key);
+    if (pending == m_pendingSetpoints.end()) {
+        return;
+    }
+    std::deque<Entry>& lane = m_lanes[static_cast<std::size_t>(TxPriority::Setpoint)];
+    auto stale = std::find_if(lane.begin(), lane.end(), [&](const Entry& entry) { return &entry == pending->second; });
+    stale->promise->set_value(false);
+    lane.erase(stale);
+
+    // Erasing from the middle of a deque moves the other entries
+    m_pendingSetpoints.clear();
+    for (Entry& entry : lane) {
+        m_pendingSetpoints[coalescingKey(entry.message)] = &entry;
+    }
+}
+
+void CANTransmitQueue::transmitLoop() {
+    while (true) {
+        Entry entry;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_workAvailable.wait(lock, [this] {
+                return m_stopping || !m_lanes[0].empty() || !m_lanes[1].empty() || !m_lanes[2].empty();
+            });
+            if (m_stopping) {
+                // Shutdown commands still go out; stop() fails everything else
+                std::deque<Entry> safety = std::move(m_lanes[static_cast<std::size_t>(TxPriority::Safety)]);
+                m_lanes[static_cast<std::size_t>(TxPriority::Safety)].clear();
+                lock.unlock();
+                for (const Entry& pending : safety) {
+                    pending.promise->set_value(transmit(pending));
+                }
+                return;
+            }
+            // Strict priority: always take from the most urgent non-empty lane
+            std::size_t laneIndex = 0;
+            while (m_lanes[laneIndex].empty()) {
+                ++laneIndex;
+            }
+            std::deque<Entry>& lane = m_lanes[laneIndex];
+            if (laneIndex == static_cast<std::size_t>(TxPriority::Setpoint)) {
+                m_pendingSetpoints.erase(coalescingKey(lane.front().message));
+            }
+            entry = std::move(lane.front());
+            lane.pop_front();
+        }
+
+        entry.promise->set_value(transmit(entry));
+    }
+}
+
+bool CANTransmitQueue::transmit(const Entry& entry) {
+    TPCANMsgFD messageFD = entry.message;
+    if (entry.fd) {
+        return m_can.sendCANMessageFD(messageFD);
+    }
+    TPCANMsg message;
+    message.ID = entry.message.ID;
+    message.MSGTYPE = entry.message.MSGTYPE;
+    message.LEN = entry.message.DLC;
+    std::memcpy(message.DATA, entry.message.DATA, sizeof(message.DATA));
+    return m_can.sendCANMessage(message);
+}
+
+void CANTransmitQueue::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping) {
+            return;
+        }
+        m_stopping = true;
+    }
+    m_workAvailable.notify_one();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (std::deque<Entry>& lane : m_lanes) {
+        for (Entry& entry : lane) {
+            entry.promise->set_value(false);
+        }
+        lane.clear();
+    }
+    m_pendingSetpoints.clear();
+}
+
+std::size_t CANTransmitQueue::pendingCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_lanes[0].size() + m_lanes[1].size() + m_lanes[2].size();
+}
+
+unsigned long long CANTransmitQueue::coalescedCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_coalesced;
+}
@@ -0,0 +1,84 @@
+#ifndef CAN_TRANSMIT_QUEUE_HPP
+#define CAN_TRANSMIT_QUEUE_HPP
+
+#include "can_interface.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+// Transmit lanes, highest priority first
+enum class TxPriority {
+    Safety = 0,    // Emergency stop / shutdown commands
+    Command = 1,   // Mode changes, heartbeats
+    Setpoint = 2,  // Current/voltage setpoints; superseded values are coalesced
+};
+
+// Asynchronous per-channel transmit path for a CANInterface.
+//
+// A dedicated thread sends queued frames one at a time, always taking the
+// next frame from the highest-priority non-empty lane, so a Safety frame
+// is never queued behind setpoints (it can only wait for the single frame
+// already being written).
+//
+// A Setpoint frame for a CAN ID that is still waiting in the Setpoint lane
+// replaces the waiting frame's payload in place instead of queueing a
+// second frame. Both callers then receive the completion of the frame that
+// is actually sent. A Safety or Command frame drops the setpoint still
+// waiting for its CAN ID (completing it with false), so a stale setpoint is
+// never sent after the command that replaced it.
+class CANTransmitQueue {
+public:
+    explicit CANTransmitQueue(CANInterface& can);
+    ~CANTransmitQueue();
+
+    CANTransmitQueue(const CANTransmitQueue&) = delete;
+    CANTransmitQueue& operator=(const CANTransmitQueue&) = delete;
+
+    // The future becomes true once the frame was handed to the driver,
+    // false if the write failed or the queue was stopped first.
+    std::shared_future<bool> send(const TPCANMsg& message, TxPriority priority = TxPriority::Setpoint);
+    std::shared_future<bool> sendFD(const TPCANMsgFD& message, TxPriority priority = TxPriority::Setpoint);
+
+    // Stops the transmit thread. Safety frames still waiting are sent first;
+    // all other waiting frames complete with false.
+    void stop();
+
+    std::size_t pendingCount() const;
+    unsigned long long coalescedCount() const;
+
+private:
+    static constexpr std::size_t LaneCount = 3;
+
+    struct Entry {
+        TPCANMsgFD message;
+        bool fd;
+        std::shared_ptr<std::promise<bool>> promise;
+        std::shared_future<bool> future;
+    };
+
+    std::shared_future<bool> enqueue(const TPCANMsgFD& message, bool fd, TxPriority priority);
+    void dropPendingSetpoint(std::uint32_t key);  // Called with m_mutex held
+    bool transmit(const Entry& entry);
+    void transmitLoop();
+    static std::uint32_t coalescingKey(const TPCANMsgFD& message);
+
+    CANInterface& m_can;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_workAvailable;
+    std::deque<Entry> m_lanes[LaneCount];
+    // Setpoint entries still waiting, by CAN ID. Elements of a deque keep
+    // their address until they are popped.
+    std::unordered_map<std::uint32_t, Entry*> m_pendingSetpoints;
+    unsigned long long m_coalesced = 0;
+    bool m_stopping = false;
+
+    std::thread m_thread;
+};
+
+#endif // CAN_TRANSMIT_QUEUE_HPP
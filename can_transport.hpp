@@ -0,0 +1,92 @@
+#ifndef CAN_TRANSPORT_HPP
+#define CAN_TRANSPORT_HPP
+
+#include "PCANBasic.h"
+#include <cstddef>
+#include <string>
+
+// Payload length in bytes for a CAN FD data length code (0..15)
+inline std::size_t canFdDlcToLength(BYTE dlc) {
+    static const std::size_t lengths[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64 };
+    return lengths[dlc & 0x0F];
+}
+
+// Smallest CAN FD data length code able to carry length bytes
+inline BYTE canFdLengthToDlc(std::size_t length) {
+    if (length <= 8) return static_cast<BYTE>(length);
+    if (length <= 12) return 9;
+    if (length <= 16) return 10;
+    if (length <= 20) return 11;
+    if (length <= 24) return 12;
+    if (length <= 32) return 13;
+    if (length <= 48) return 14;
+    return 15;
+}
+
+// Low-level CAN channel backend used by CANInterface.
+//
+// Implementations wrap a concrete driver (PCAN-Basic, SocketCAN) or a
+// simulated bus. All of them speak the PCAN-Basic vocabulary: frames are
+// TPCANMsg/TPCANMsgFD and results are TPCANStatus codes, with
+// PCAN_ERROR_QRCVEMPTY meaning "nothing to read".
+//
+// Thread safety: write/writeFD may be called concurrently with the read
+// functions, but each group must be serialized by the caller (CANInterface
+// holds separate read and write mutexes). wakeReceiver may be called from
+// any thread.
+class CANTransport {
+public:
+    virtual ~CANTransport() = default;
+
+    virtual TPCANStatus initialize(TPCANBaudrate baudrate) = 0;
+    virtual TPCANStatus initializeFD(const std::string& bitrateFD) = 0;
+    virtual void uninitialize() = 0;
+
+    virtual TPCANStatus write(TPCANMsg& message) = 0;
+    virtual TPCANStatus writeFD(TPCANMsgFD& message) = 0;
+
+    // timestamp may be nullptr
+    virtual TPCANStatus read(TPCANMsg& message, TPCANTimestamp* timestamp) = 0;
+    virtual TPCANStatus readFD(TPCANMsgFD& message, TPCANTimestampFD* timestamp) = 0;
+
+    // Reads up to maxCount frames. status receives the code that ended the
+    // batch (PCAN_ERROR_QRCVEMPTY when the queue ran dry, PCAN_ERROR_OK when
+    // maxCount was reached). Backends with a native batch read override these.
+    virtual std::size_t readBatch(TPCANMsg* messages, TPCANTimestamp* timestamps,
+                                  std::size_t maxCount, TPCANStatus& status) {
+        std::size_t count = 0;
+        status = PCAN_ERROR_OK;
+        while (count < maxCount) {
+            status = read(messages[count], timestamps != nullptr ? &timestamps[count] : nullptr);
+            if (status != PCAN_ERROR_OK) {
+                break;
+            }
+            ++count;
+        }
+        return count;
+    }
+
+    virtual std::size_t readBatchFD(TPCANMsgFD* messages, TPCANTimestampFD* timestamps,
+                                    std::size_t maxCount, TPCANStatus& status) {
+        std::size_t count = 0;
+        status = PCAN_ERROR_OK;
+        while (count < maxCount) {
+            status = readFD(messages[count], timestamps != nullptr ? &timestamps[count] : nullptr);
+            if (status != PCAN_ERROR_OK) {
+                break;
+            }
+            ++count;
+        }
+        return count;
+    }
+
+    // Blocks until frames may be available to read, wakeReceiver() is
+    // called, or timeoutMs elapses. Returns false on timeout. Backends
+    // without a receive notification return false immediately and the
+    // caller falls back to polling.
+    virtual bool waitForReceive(unsigned int timeoutMs) = 0;
+    virtual void wakeReceiver() = 0;
+    virtual bool hasReceiveNotification() const = 0;
+};
+
+#endif // CAN_TRANSPORT_HPP
@@ -0,0 +1,163 @@
+#include "cell_voltage_decoder.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CELL_DECODER_AVX2 1
+#include <immintrin.h>
+#endif
+
+// Both kernels load up to two bytes past a cell's last DATA byte. The PCAN
+// frame structs have that much tail padding, so the reads stay inside the
+// frame even for the last cell of the last frame.
+static_assert(sizeof(TPCANMsg) >= offsetof(TPCANMsg, DATA) + sizeof(TPCANMsg::DATA) + 2, "TPCANMsg tail padding");
+static_assert(sizeof(TPCANMsgFD) >= offsetof(TPCANMsgFD, DATA) + sizeof(TPCANMsgFD::DATA) + 2, "TPCANMsgFD tail padding");
+
+namespace {
+
+#ifdef CELL_DECODER_AVX2
+// Decodes one cell for 8 frames per iteration: a gather picks the cell's
+// 32-bit window out of each frame, then shift, mask, sign extension and
+// scaling run on all 8 lanes. Returns the number of frames done.
+__attribute__((target("avx2")))
+std::size_t decodeCellAvx2(const std::uint8_t* cellData, std::size_t frameSize, std::size_t frameCount,
+                           unsigned int shift, std::uint32_t mask, unsigned int signShift,
+                           float factor, float offset, float* values) {
+    const __m256i frameOffsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                                    _mm256_set1_epi32(static_cast<int>(frameSize)));
+    const __m128i shiftCount = _mm_cvtsi32_si128(static_cast<int>(shift));
+    const __m128i signCount = _mm_cvtsi32_si128(static_cast<int>(signShift));
+    const __m256i maskVector = _mm256_set1_epi32(static_cast<int>(mask));
+    const __m256 factorVector = _mm256_set1_ps(factor);
+    const __m256 offsetVector = _mm256_set1_ps(offset);
+
+    std::size_t frame = 0;
+    for (; frame + 8 <= frameCount; frame += 8) {
+        __m256i raw = _mm256_i32gather_epi32(reinterpret_cast<const int*>(cellData + frame * frameSize), frameOffsets, 1);
+        raw = _mm256_and_si256(_mm256_srl_epi32(raw, shiftCount), maskVector);
+        raw = _mm256_sra_epi32(_mm256_sll_epi32(raw, signCount), signCount);
+        const __m256 physical = _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(raw), factorVector), offsetVector);
+        _mm256_storeu_ps(values + frame, physical);
+    }
+    return frame;
+}
+#endif
+
+} // namespace
+
+bool cellLayoutFromMessage(const DBCMessage& message, CellFrameLayout& layout, std::string_view signalPrefix) {
+    std::vector<const DBCSignal*> cells;
+    for (const DBCSignal& signal : message.signals) {
+        if (!signal.isMultiplexor && signal.name.compare(0, signalPrefix.size(), signalPrefix) == 0) {
+            cells.push_back(&signal);
+        }
+    }
+    if (cells.empty() || cells.size() > 255) {
+        return false;
+    }
+    std::sort(cells.begin(), cells.end(), [](const DBCSignal* a, const DBCSignal* b) { return a->startBit < b->startBit; });
+
+    const DBCSignal& first = *cells.front();
+    const unsigned int stride = cells.size() > 1 ? cells[1]->startBit - first.startBit : first.bitLength;
+    for (std::size_t i = 0; i < cells.size(); ++i) {
+        const DBCSignal& cell = *cells[i];
+        if (cell.byteOrder != DBCByteOrder::Intel || cell.valueType != DBCValueType::Integer
+            || cell.bitLength != first.bitLength || cell.isSigned != first.isSigned
+            || cell.factor != first.factor || cell.offset != first.offset
+            || cell.startBit != first.startBit + i * stride) {
+            return false;
+        }
+    }
+    if (first.bitLength > 16 || stride < first.bitLength || message.size == 0 || message.size > 64
+        || cells.back()->startBit + cells.back()->bitLength > message.size * 8U) {
+        return false;
+    }
+
+    layout.firstBit = first.startBit;
+    layout.cellStride = static_cast<std::uint16_t>(stride);
+    layout.bitsPerCell = static_cast<std::uint8_t>(first.bitLength);
+    layout.cellCount = static_cast<std::uint8_t>(cells.size());
+    layout.frameBytes = static_cast<std::uint8_t>(message.size);
+    layout.isSigned = first.isSigned;
+    layout.factor = static_cast<float>(first.factor);
+    layout.offset = static_cast<float>(first.offset);
+    return true;
+}
+
+CellVoltageDecoder::CellVoltageDecoder(const CellFrameLayout& layout)
+    : m_layout(layout), m_mask((1U << std::min<unsigned int>(layout.bitsPerCell, 16)) - 1) {
+    if (layout.bitsPerCell < 1 || layout.bitsPerCell > 16 || layout.frameBytes < 1 || layout.frameBytes > 64) {
+        std::cerr << "Cell frame layout rejected! " << static_cast<unsigned int>(layout.bitsPerCell)
+                  << " bits per cell in " << static_cast<unsigned int>(layout.frameBytes) << " byte frames" << std::endl;
+        m_valid = false;
+        return;
+    }
+    const unsigned int frameBits = layout.frameBytes * 8U;
+    for (unsigned int cell = 0; cell < layout.cellCount; ++cell) {
+        const unsigned int bit = layout.firstBit + cell * layout.cellStride;
+        if (bit + layout.bitsPerCell > frameBits) {
+            std::cerr << "Cell frame layout: cell " << cell << " (bits " << bit << ".." << bit + layout.bitsPerCell - 1
+                      << ") is outside the " << static_cast<unsigned int>(layout.frameBytes) << " byte frame, dropped"
+                      << std::endl;
+            m_valid = false;
+            break;  // Cells are evenly spaced, so every following one is outside too
+        }
+        m_cells.push_back(CellPlan{static_cast<std::uint16_t>(bit / 8), static_cast<std::uint8_t>(bit % 8)});
+    }
+}
+
+bool CellVoltageDecoder::hasAvx2() {
+#ifdef CELL_DECODER_AVX2
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+bool CellVoltageDecoder::decode(const TPCANMsg* frames, std::size_t frameCount, float* values, std::size_t stride) const {
+    if (m_layout.frameBytes > sizeof(TPCANMsg::DATA)) {
+        return false;
+    }
+    decodeFrames(frames, frameCount, values, stride);
+    return true;
+}
+
+bool CellVoltageDecoder::decode(const TPCANMsgFD* frames, std::size_t frameCount, float* values, std::size_t stride) const {
+    decodeFrames(frames, frameCount, values, stride);
+    return true;
+}
+
+template <typename Frame>
+void CellVoltageDecoder::decodeFrames(const Frame* frames, std::size_t frameCount, float* values, std::size_t stride) const {
+    const std::uint8_t* data = reinterpret_cast<const std::uint8_t*>(frames) + offsetof(Frame, DATA);
+    const std::size_t readableBytes = sizeof(Frame) - offsetof(Frame, DATA);
+    const unsigned int signShift = m_layout.isSigned ? 32U - m_layout.bitsPerCell : 0U;
+    const bool avx2 = hasAvx2();
+
+    for (std::size_t cell = 0; cell < m_cells.size(); ++cell) {
+        const CellPlan& plan = m_cells[cell];
+        const std::uint8_t* cellData = data + plan.byteOffset;
+        float* cellValues = values + cell * stride;
+
+        std::size_t frame = 0;
+#ifdef CELL_DECODER_AVX2
+        if (avx2 && plan.byteOffset + 4U <= readableBytes) {
+            frame = decodeCellAvx2(cellData, sizeof(Frame), frameCount, plan.shift, m_mask, signShift,
+                                   m_layout.factor, m_layout.offset, cellValues);
+        }
+#else
+        (void)avx2;
+        (void)readableBytes;
+#endif
+        for (; frame < frameCount; ++frame) {
+            const std::uint8_t* bytes = cellData + frame * sizeof(Frame);
+            const std::uint32_t window = bytes[0] | (static_cast<std::uint32_t>(bytes[1]) << 8)
+                                       | (static_cast<std::uint32_t>(bytes[2]) << 16);
+            const std::uint32_t raw = (window >> plan.shift) & m_mask;
+            const std::int32_t value = static_cast<std::int32_t>(raw << signShift) >> signShift;
+            cellValues[frame] = static_cast<float>(value) * m_layout.factor + m_layout.offset;
+        }
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef CELL_VOLTAGE_DECODER_HPP
+#define CELL_VOLTAGE_DECODER_HPP
+
+#include "PCANBasic.h"
+#include "dbc_database.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Layout of a BMS frame carrying evenly spaced packed cell values
+// (typically 12 or 16 bit cell voltages, Intel byte order).
+struct CellFrameLayout {
+    std::uint16_t firstBit = 0;     // Start bit (LSB) of cell 0
+    std::uint16_t cellStride = 16;  // Bits from one cell to the next
+    std::uint8_t bitsPerCell = 16;  // 1..16
+    std::uint8_t cellCount = 4;
+    std::uint8_t frameBytes = 8;    // Payload length (DLC bytes, 1..64) every cell must fit in
+    bool isSigned = false;
+    float factor = 0.001f;
+    float offset = 0.0f;
+};
+
+// Derives a layout from a DBC message whose signals (those starting with
+// signalPrefix, if given) are Intel, equally sized and scaled, and evenly
+// spaced. Returns false if they are not.
+bool cellLayoutFromMessage(const DBCMessage& message, CellFrameLayout& layout, std::string_view signalPrefix = {});
+
+// Batch decoder for frames sharing one CellFrameLayout. Output is SoA:
+// the value of cell c in frames[f] is written to values[c * stride + f],
+// so every cell's samples end up contiguous.
+//
+// Uses AVX2 (gathering the same cell from 8 frames at once) when the CPU
+// supports it and a scalar loop otherwise. Frames must be frameBytes long;
+// the caller filters by ID and length.
+//
+// The layout is checked on construction: cells that do not fit in
+// frameBytes are reported and dropped, and isValid() turns false.
+class CellVoltageDecoder {
+public:
+    explicit CellVoltageDecoder(const CellFrameLayout& layout);
+
+    // Return false, decoding nothing, if the layout needs more payload than
+    // the frame type carries (frameBytes > 8 for classic frames)
+    bool decode(const TPCANMsg* frames, std::size_t frameCount, float* values, std::size_t stride) const;
+    bool decode(const TPCANMsgFD* frames, std::size_t frameCount, float* values, std::size_t stride) const;
+
+    const CellFrameLayout& layout() const { return m_layout; }
+    bool isValid() const { return m_valid; }
+    std::size_t cellCount() const { return m_cells.size(); }  // Cells that passed validation
+    static bool hasAvx2();
+
+private:
+    struct CellPlan {
+        std::uint16_t byteOffset;
+        std::uint8_t shift;
+    };
+
+    template <typename Frame>
+    void decodeFrames(const Frame* frames, std::size_t frameCount, float* values, std::size_t stride) const;
+
+    CellFrameLayout m_layout;
+    std::vector<CellPlan> m_cells;
+    std::uint32_t m_mask;
+    bool m_valid = true;
+};
+
+#endif // CELL_VOLTAGE_DECODER_HPP
@@ -0,0 +1,271 @@
+#include "cyclic_transmit_scheduler.hpp"
+#include "monotonic_clock.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#ifdef _WIN32
+#include <windows.h>
+#include <mmsystem.h>
+#endif
+
+namespace {
+
+// CyclicMessageId = generation (high 12 bits) | entry index (low 20 bits)
+constexpr std::uint32_t IndexBits = 20;
+constexpr std::uint32_t IndexMask = (1U << IndexBits) - 1;
+
+} // namespace
+
+CyclicTransmitScheduler::CyclicTransmitScheduler() {
+    std::fill(std::begin(m_level0), std::end(m_level0), NoEntry);
+    std::fill(std::begin(m_level1), std::end(m_level1), NoEntry);
+    std::fill(std::begin(m_level2), std::end(m_level2), NoEntry);
+#ifdef _WIN32
+    // The default 15.6 ms Windows timer resolution would swamp a 1 ms tick
+    timeBeginPeriod(1);
+#endif
+    m_startUs = monotonicMicros();
+    m_thread = std::thread(&CyclicTransmitScheduler::schedulerLoop, this);
+}
+
+CyclicTransmitScheduler::~CyclicTransmitScheduler() {
+    stop();
+}
+
+void CyclicTransmitScheduler::stop() {
+    if (!m_running.exchange(false)) {
+        return;
+    }
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+#ifdef _WIN32
+    timeEndPeriod(1);
+#endif
+}
+
+CyclicMessageId CyclicTransmitScheduler::addMessage(CANTransmitQueue& queue, const TPCANMsg& message,
+                                                    std::chrono::milliseconds period, TxPriority priority,
+                                                    std::chrono::milliseconds phase) {
+    TPCANMsgFD messageFD;
+    messageFD.ID = message.ID;
+    messageFD.MSGTYPE = message.MSGTYPE;
+    messageFD.DLC = message.LEN;
+    std::memset(messageFD.DATA, 0, sizeof(messageFD.DATA));
+    std::memcpy(messageFD.DATA, message.DATA, sizeof(message.DATA));
+    return add(queue, messageFD, false, period, priority, phase);
+}
+
+CyclicMessageId CyclicTransmitScheduler::addMessageFD(CANTransmitQueue& queue, const TPCANMsgFD& message,
+                                                      std::chrono::milliseconds period, TxPriority priority,
+                                                      std::chrono::milliseconds phase) {
+    return add(queue, message, true, period, priority, phase);
+}
+
+CyclicMessageId CyclicTransmitScheduler::add(CANTransmitQueue& queue, const TPCANMsgFD& message, bool fd,
+                                             std::chrono::milliseconds period, TxPriority priority,
+                                             std::chrono::milliseconds phase) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::uint32_t index;
+    if (!m_freeEntries.empty()) {
+        index = m_freeEntries.back();
+        m_freeEntries.pop_back();
+    } else {
+        index = static_cast<std::uint32_t>(m_entries.size());
+        m_entries.emplace_back();
+    }
+
+    Entry& entry = m_entries[index];
+    const std::uint32_t generation = entry.generation;
+    entry = Entry();
+    entry.generation = generation;
+    entry.queue = &queue;
+    entry.message = message;
+    entry.fd = fd;
+    entry.priority = priority;
+    entry.periodTicks = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(period.count()) * 1000 / TickUs);
+    entry.dueTick = m_currentTick + static_cast<std::uint64_t>(phase.count()) * 1000 / TickUs;
+    entry.active = true;
+    insert(index);
+    return (generation << IndexBits) | index;
+}
+
+CyclicTransmitScheduler::Entry* CyclicTransmitScheduler::find(CyclicMessageId id) {
+    const std::uint32_t index = id & IndexMask;
+    if (index >= m_entries.size()) {
+        return nullptr;
+    }
+    Entry& entry = m_entries[index];
+    if (!entry.active || (entry.generation & (0xFFFFFFFFU >> IndexBits)) != (id >> IndexBits)) {
+        return nullptr;
+    }
+    return &entry;
+}
+
+const CyclicTransmitScheduler::Entry* CyclicTransmitScheduler::find(CyclicMessageId id) const {
+    return const_cast<CyclicTransmitScheduler*>(this)->find(id);
+}
+
+bool CyclicTransmitScheduler::removeMessage(CyclicMessageId id) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry* entry = find(id);
+    if (entry == nullptr) {
+        return false;
+    }
+    // The entry is unlinked and recycled when its slot next fires
+    entry->active = false;
+    return true;
+}
+
+bool CyclicTransmitScheduler::updatePayload(CyclicMessageId id, const BYTE* data, std::size_t length) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry* entry = find(id);
+    if (entry == nullptr) {
+        return false;
+    }
+    const std::size_t capacity = entry->fd ? sizeof(entry->message.DATA) : 8;
+    length = std::min(length, capacity);
+    std::memcpy(entry->message.DATA, data, length);
+    entry->message.DLC = entry->fd ? canFdLengthToDlc(length) : static_cast<BYTE>(length);
+    return true;
+}
+
+bool CyclicTransmitScheduler::jitterStats(CyclicMessageId id, CyclicJitterStats& stats) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const Entry* entry = find(id);
+    if (entry == nullptr) {
+        return false;
+    }
+    stats = entry->stats;
+    stats.stddevUs = entry->stats.sentCount > 1 ? std::sqrt(entry->m2 / (entry->stats.sentCount - 1)) : 0.0;
+    return true;
+}
+
+void CyclicTransmitScheduler::resetJitterStats(CyclicMessageId id) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry* entry = find(id);
+    if (entry != nullptr) {
+        entry->stats = CyclicJitterStats();
+        entry->m2 = 0.0;
+    }
+}
+
+// Called with m_mutex held
+void CyclicTransmitScheduler::insert(std::uint32_t index) {
+    Entry& entry = m_entries[index];
+    const std::uint64_t due = std::max(entry.dueTick, m_currentTick);
+    const std::uint64_t delta = due - m_currentTick;
+    std::uint32_t* slot;
+    if (delta < Level0Span) {
+        slot = &m_level0[due % Level0Slots];
+    } else if (delta < Level1Span) {
+        slot = &m_level1[(due / Level0Span) % Level1Slots];
+    } else {
+        // Beyond the top level's range the entry is simply re-cascaded until due
+        const std::uint64_t capped = std::min(due, m_currentTick + Level1Span * Level2Slots - 1);
+        slot = &m_level2[(capped / Level1Span) % Level2Slots];
+    }
+    entry.next = *slot;
+    *slot = index;
+}
+
+// Re-inserts every entry of a higher-level slot; called with m_mutex held
+void CyclicTransmitScheduler::cascade(std::uint32_t* slots, std::size_t slot) {
+    std::uint32_t index = slots[slot];
+    slots[slot] = NoEntry;
+    while (index != NoEntry) {
+        const std::uint32_t next = m_entries[index].next;
+        if (m_entries[index].active) {
+            insert(index);
+        } else {
+            m_entries[index].generation++;
+            m_freeEntries.push_back(index);
+        }
+        index = next;
+    }
+}
+
+// Called with m_mutex held
+void CyclicTransmitScheduler::runTick(std::uint64_t tick, std::uint64_t elapsedTick, std::uint64_t nowUs) {
+    if (tick % Level0Span == 0) {
+        if (tick % Level1Span == 0) {
+            cascade(m_level2, (tick / Level1Span) % Level2Slots);
+        }
+        cascade(m_level1, (tick / Level0Span) % Level1Slots);
+    }
+
+    std::uint32_t index = m_level0[tick % Level0Slots];
+    m_level0[tick % Level0Slots] = NoEntry;
+    while (index != NoEntry) {
+        const std::uint32_t next = m_entries[index].next;
+        Entry& entry = m_entries[index];
+        if (!entry.active) {
+            entry.generation++;
+            m_freeEntries.push_back(index);
+        } else if (entry.dueTick > tick) {
+            insert(index);  // Capped level-2 entry that is not due yet
+        } else {
+            fire(index, elapsedTick, nowUs);
+        }
+        index = next;
+    }
+}
+
+// Called with m_mutex held
+void CyclicTransmitScheduler::fire(std::uint32_t index, std::uint64_t elapsedTick, std::uint64_t nowUs) {
+    Entry& entry = m_entries[index];
+    if (entry.fd) {
+        entry.queue->sendFD(entry.message, entry.priority);
+    } else {
+        TPCANMsg message;
+        message.ID = entry.message.ID;
+        message.MSGTYPE = entry.message.MSGTYPE;
+        message.LEN = entry.message.DLC;
+        std::memcpy(message.DATA, entry.message.DATA, sizeof(message.DATA));
+        entry.queue->send(message, entry.priority);
+    }
+
+    const std::int64_t jitterUs = static_cast<std::int64_t>(nowUs) -
+                                  static_cast<std::int64_t>(m_startUs + entry.dueTick * TickUs);
+    CyclicJitterStats& stats = entry.stats;
+    stats.sentCount++;
+    if (stats.sentCount == 1) {
+        stats.minUs = stats.maxUs = jitterUs;
+    } else {
+        stats.minUs = std::min(stats.minUs, jitterUs);
+        stats.maxUs = std::max(stats.maxUs, jitterUs);
+    }
+    const double delta = static_cast<double>(jitterUs) - stats.meanUs;
+    stats.meanUs += delta / static_cast<double>(stats.sentCount);
+    entry.m2 += delta * (static_cast<double>(jitterUs) - stats.meanUs);
+
+    // Stay on the original grid; if we fell behind, skip the periods that are
+    // already over instead of sending them back to back
+    entry.dueTick += entry.periodTicks;
+    if (entry.dueTick <= elapsedTick) {
+        const std::uint64_t missed = (elapsedTick - entry.dueTick) / entry.periodTicks + 1;
+        stats.skippedCount += missed;
+        entry.dueTick += missed * entry.periodTicks;
+    }
+    insert(index);
+}
+
+void CyclicTransmitScheduler::schedulerLoop() {
+    while (m_running.load(std::memory_order_relaxed)) {
+        std::uint64_t nextTick;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const std::uint64_t nowUs = monotonicMicros();
+            const std::uint64_t elapsedTicks = (nowUs - m_startUs) / TickUs;
+            // Process every tick that has come due, including any we overslept
+            while (m_currentTick <= elapsedTicks) {
+                runTick(m_currentTick, elapsedTicks, nowUs);
+                ++m_currentTick;
+            }
+            nextTick = m_currentTick;
+        }
+        const auto wakeAt = std::chrono::steady_clock::time_point(
+            std::chrono::microseconds(m_startUs + nextTick * TickUs));
+        std::this_thread::sleep_until(wakeAt);
+    }
+}
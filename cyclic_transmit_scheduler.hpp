@@ -0,0 +1,109 @@
+#ifndef CYCLIC_TRANSMIT_SCHEDULER_HPP
+#define CYCLIC_TRANSMIT_SCHEDULER_HPP
+
+#include "can_transmit_queue.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using CyclicMessageId = std::uint32_t;
+
+// Send-time deviation from the ideal schedule, in microseconds
+struct CyclicJitterStats {
+    std::uint64_t sentCount = 0;
+    std::uint64_t skippedCount = 0;  // Periods dropped because the scheduler fell behind
+    double meanUs = 0.0;
+    double stddevUs = 0.0;
+    std::int64_t minUs = 0;
+    std::int64_t maxUs = 0;
+};
+
+// Sends periodic frames (heartbeats, setpoints) for any number of
+// channels from a single thread.
+//
+// Due times live in a three-level hierarchical timer wheel with a 1 ms tick
+// (256 x 1 ms, 64 x 256 ms, 64 x 16.4 s), so each tick costs O(frames due)
+// no matter how many messages are registered. Due times are computed from
+// the start time and never accumulate drift; frames are handed to the
+// channel's CANTransmitQueue, so the scheduler thread never blocks on a driver.
+class CyclicTransmitScheduler {
+public:
+    static constexpr std::uint64_t TickUs = 1000;
+
+    CyclicTransmitScheduler();
+    ~CyclicTransmitScheduler();
+
+    CyclicTransmitScheduler(const CyclicTransmitScheduler&) = delete;
+    CyclicTransmitScheduler& operator=(const CyclicTransmitScheduler&) = delete;
+
+    // phase delays the first transmission, e.g. to spread messages of equal period
+    CyclicMessageId addMessage(CANTransmitQueue& queue, const TPCANMsg& message,
+                               std::chrono::milliseconds period,
+                               TxPriority priority = TxPriority::Command,
+                               std::chrono::milliseconds phase = std::chrono::milliseconds(0));
+    CyclicMessageId addMessageFD(CANTransmitQueue& queue, const TPCANMsgFD& message,
+                                 std::chrono::milliseconds period,
+                                 TxPriority priority = TxPriority::Command,
+                                 std::chrono::milliseconds phase = std::chrono::milliseconds(0));
+    bool removeMessage(CyclicMessageId id);
+
+    // Replace the payload sent from the next period on
+    bool updatePayload(CyclicMessageId id, const BYTE* data, std::size_t length);
+
+    bool jitterStats(CyclicMessageId id, CyclicJitterStats& stats) const;
+    void resetJitterStats(CyclicMessageId id);
+
+    void stop();
+
+private:
+    static constexpr std::size_t Level0Slots = 256;
+    static constexpr std::size_t Level1Slots = 64;
+    static constexpr std::size_t Level2Slots = 64;
+    static constexpr std::uint64_t Level0Span = Level0Slots;
+    static constexpr std::uint64_t Level1Span = Level0Span * Level1Slots;
+    static constexpr std::uint32_t NoEntry = 0xFFFFFFFFU;
+
+    struct Entry {
+        CANTransmitQueue* queue = nullptr;
+        TPCANMsgFD message;
+        bool fd = false;
+        TxPriority priority = TxPriority::Command;
+        std::uint64_t periodTicks = 1;
+        std::uint64_t dueTick = 0;
+        std::uint32_t next = NoEntry;     // Intrusive list link within a wheel slot
+        std::uint32_t generation = 0;     // Distinguishes reused slots in CyclicMessageId
+        bool active = false;
+        // Welford accumulators for the jitter statistics
+        CyclicJitterStats stats;
+        double m2 = 0.0;
+    };
+
+    CyclicMessageId add(CANTransmitQueue& queue, const TPCANMsgFD& message, bool fd,
+                        std::chrono::milliseconds period, TxPriority priority,
+                        std::chrono::milliseconds phase);
+    Entry* find(CyclicMessageId id);
+    const Entry* find(CyclicMessageId id) const;
+    void insert(std::uint32_t index);
+    void cascade(std::uint32_t* slots, std::size_t slot);
+    // tick is the wheel tick being processed, elapsedTick the tick nowUs falls in
+    void runTick(std::uint64_t tick, std::uint64_t elapsedTick, std::uint64_t nowUs);
+    void fire(std::uint32_t index, std::uint64_t elapsedTick, std::uint64_t nowUs);
+    void schedulerLoop();
+
+    mutable std::mutex m_mutex;
+    std::vector<Entry> m_entries;
+    std::vector<std::uint32_t> m_freeEntries;
+    std::uint32_t m_level0[Level0Slots];
+    std::uint32_t m_level1[Level1Slots];
+    std::uint32_t m_level2[Level2Slots];
+    std::uint64_t m_currentTick = 0;     // Next tick to be processed
+    std::uint64_t m_startUs = 0;
+
+    std::atomic<bool> m_running{true};
+    std::thread m_thread;
+};
+
+#endif // CYCLIC_TRANSMIT_SCHEDULER_HPP
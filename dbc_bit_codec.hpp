@@ -0,0 +1,176 @@
+#ifndef DBC_BIT_CODEC_HPP
+#define DBC_BIT_CODEC_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// Bit-level helpers for reading and writing DBC signals in a CAN payload,
+// shared by the runtime decoder and the headers generated by dbc_codegen.
+//
+// A signal is read by loading an 8-byte window starting at byteOffset
+// (little endian for Intel, big endian for Motorola signals) and computing
+// (window >> shift) & mask; writing is the matching read-modify-write of the
+// window. The caller must provide 8 accessible bytes past byteOffset, i.e. a
+// payload buffer padded to 64 + 8 bytes.
+
+constexpr std::uint64_t dbcBitMask(unsigned int length) {
+    return length >= 64 ? ~0ULL : ((1ULL << length) - 1);
+}
+
+struct DBCBitWindow {
+    std::uint16_t byteOffset;     // First byte of the 8-byte window
+    std::uint8_t shift;           // Right shift applied to the loaded window
+    bool fits;                    // False if the signal spans more than 8 bytes from byteOffset
+    std::uint16_t requiredBytes;  // Payload bytes the signal reaches into
+};
+
+constexpr DBCBitWindow dbcIntelWindow(unsigned int startBit, unsigned int length) {
+    return DBCBitWindow{
+        static_cast<std::uint16_t>(startBit / 8),
+        static_cast<std::uint8_t>(startBit % 8),
+        (startBit % 8) + length <= 64,
+        static_cast<std::uint16_t>((startBit + length + 7) / 8)};
+}
+
+// Motorola start bits use the DBC sawtooth numbering and name the MSB. Bit
+// positions are converted to a linear big-endian index first (0 = MSB of
+// byte 0), in which the signal is a contiguous run.
+constexpr DBCBitWindow dbcMotorolaWindow(unsigned int startBit, unsigned int length) {
+    const unsigned int msb = (startBit / 8) * 8 + (7 - startBit % 8);
+    const bool fits = (msb % 8) + length <= 64;
+    return DBCBitWindow{
+        static_cast<std::uint16_t>(msb / 8),
+        static_cast<std::uint8_t>(fits ? 64 - (msb % 8) - length : 0),
+        fits,
+        static_cast<std::uint16_t>((msb + length + 7) / 8)};
+}
+
+inline std::uint64_t dbcLoadLittleEndian64(const std::uint8_t* bytes) {
+    std::uint64_t value;
+    std::memcpy(&value, bytes, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    value = __builtin_bswap64(value);
+#endif
+    return value;
+}
+
+inline std::uint64_t dbcLoadBigEndian64(const std::uint8_t* bytes) {
+    std::uint64_t value;
+    std::memcpy(&value, bytes, sizeof(value));
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    value = __builtin_bswap64(value);
+#endif
+    return value;
+}
+
+inline void dbcStoreLittleEndian64(std::uint8_t* bytes, std::uint64_t value) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    value = __builtin_bswap64(value);
+#endif
+    std::memcpy(bytes, &value, sizeof(value));
+}
+
+inline void dbcStoreBigEndian64(std::uint8_t* bytes, std::uint64_t value) {
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    value = __builtin_bswap64(value);
+#endif
+    std::memcpy(bytes, &value, sizeof(value));
+}
+
+// Bit-by-bit extraction for the rare signals that do not fit one window
+// (lengths above 57 bits that are not byte aligned).
+constexpr std::uint64_t dbcExtractBitsSlow(const std::uint8_t* data, unsigned int startBit, unsigned int length, bool intel) {
+    std::uint64_t value = 0;
+    if (intel) {
+        for (unsigned int i = 0; i < length; ++i) {
+            const unsigned int bit = startBit + i;
+            value |= static_cast<std::uint64_t>((data[bit / 8] >> (bit % 8)) & 1U) << i;
+        }
+    } else {
+        unsigned int bit = startBit;
+        for (unsigned int i = 0; i < length; ++i) {
+            value = (value << 1) | ((data[bit / 8] >> (bit % 8)) & 1U);
+            bit = (bit % 8 == 0) ? bit + 15 : bit - 1;  // Continue with the MSB of the next byte
+        }
+    }
+    return value;
+}
+
+// Reads count (<= 8) bytes starting at first as one integer. Used by the
+// generated accessors, where first and count are constants and the loop
+// folds into a single load without touching bytes outside the signal.
+constexpr std::uint64_t dbcLoadBytesLittleEndian(const std::uint8_t* data, unsigned int first, unsigned int count) {
+    std::uint64_t value = 0;
+    for (unsigned int i = 0; i < count; ++i) {
+        value |= static_cast<std::uint64_t>(data[first + i]) << (8 * i);
+    }
+    return value;
+}
+
+constexpr std::uint64_t dbcLoadBytesBigEndian(const std::uint8_t* data, unsigned int first, unsigned int count) {
+    std::uint64_t value = 0;
+    for (unsigned int i = 0; i < count; ++i) {
+        value = (value << 8) | data[first + i];
+    }
+    return value;
+}
+
+// Writes the bits selected by mask from value into count bytes starting at
+// first, leaving all other bits untouched. value and mask are already
+// shifted into position within the count-byte integer.
+constexpr void dbcStoreBytesLittleEndian(std::uint8_t* data, unsigned int first, unsigned int count,
+                                         std::uint64_t value, std::uint64_t mask) {
+    for (unsigned int i = 0; i < count; ++i) {
+        const std::uint8_t byteMask = static_cast<std::uint8_t>(mask >> (8 * i));
+        data[first + i] = static_cast<std::uint8_t>((data[first + i] & ~byteMask) | (static_cast<std::uint8_t>(value >> (8 * i)) & byteMask));
+    }
+}
+
+constexpr void dbcStoreBytesBigEndian(std::uint8_t* data, unsigned int first, unsigned int count,
+                                      std::uint64_t value, std::uint64_t mask) {
+    for (unsigned int i = 0; i < count; ++i) {
+        const unsigned int shift = 8 * (count - 1 - i);
+        const std::uint8_t byteMask = static_cast<std::uint8_t>(mask >> shift);
+        data[first + i] = static_cast<std::uint8_t>((data[first + i] & ~byteMask) | (static_cast<std::uint8_t>(value >> shift) & byteMask));
+    }
+}
+
+constexpr void dbcInsertBitsSlow(std::uint8_t* data, unsigned int startBit, unsigned int length, bool intel, std::uint64_t value) {
+    unsigned int bit = startBit;
+    for (unsigned int i = 0; i < length; ++i) {
+        // Intel walks up from the LSB, Motorola down from the MSB
+        const bool set = intel ? ((value >> i) & 1U) != 0 : ((value >> (length - 1 - i)) & 1U) != 0;
+        const std::uint8_t mask = static_cast<std::uint8_t>(1U << (bit % 8));
+        data[bit / 8] = static_cast<std::uint8_t>(set ? (data[bit / 8] | mask) : (data[bit / 8] & ~mask));
+        bit = intel ? bit + 1 : ((bit % 8 == 0) ? bit + 15 : bit - 1);
+    }
+}
+
+// Sign-extends the low length bits of raw
+constexpr std::int64_t dbcSignExtend(std::uint64_t raw, unsigned int length) {
+    return length >= 64 ? static_cast<std::int64_t>(raw)
+                        : static_cast<std::int64_t>(raw << (64 - length)) >> (64 - length);
+}
+
+// Physical value to raw bits: inverse scaling, rounding to nearest and
+// saturation to the range the signal can represent. The result holds the
+// low length bits only.
+inline std::uint64_t dbcPhysicalToRaw(double value, double factor, double offset, unsigned int length, bool isSigned) {
+    const double scaled = std::nearbyint((value - offset) / factor);
+    if (isSigned) {
+        const double limit = std::ldexp(1.0, static_cast<int>(length) - 1);
+        const double clamped = std::fmin(std::fmax(scaled, -limit), limit - 1);
+        if (clamped >= limit) {
+            return dbcBitMask(length) >> 1;  // limit - 1 rounds up to limit for 64-bit signals
+        }
+        return static_cast<std::uint64_t>(static_cast<std::int64_t>(clamped)) & dbcBitMask(length);
+    }
+    const double limit = std::ldexp(1.0, static_cast<int>(length));
+    if (!(scaled > 0)) {
+        return 0;  // Also maps NaN to 0
+    }
+    return scaled >= limit ? dbcBitMask(length) : static_cast<std::uint64_t>(scaled);
+}
+
+#endif // DBC_BIT_CODEC_HPP
@@ -0,0 +1,338 @@
+#include "dbc_cache.hpp"
+#include "dbc_parser.hpp"
+#include "mapped_file.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <type_traits>
+
+namespace {
+
+constexpr std::uint32_t CacheMagic = 0x43434244;  // "DBCC" in little-endian byte order
+
+// Fixed-size header at the start of the cache file. Multi-byte fields use
+// host byte order; a foreign-endian cache fails the magic check and is rebuilt.
+struct CacheHeader {
+    std::uint32_t magic;
+    std::uint32_t formatVersion;
+    std::uint64_t sourceHash;
+    std::uint64_t sourceSize;
+    std::uint64_t payloadSize;
+    std::uint64_t payloadHash;
+};
+
+class CacheWriter {
+public:
+    template <typename T>
+    std::enable_if_t<std::is_arithmetic_v<T> || std::is_enum_v<T>> io(const T& value) {
+        m_buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void io(const std::string& text) {
+        io(static_cast<std::uint32_t>(text.size()));
+        m_buffer.append(text);
+    }
+
+    template <typename T>
+    void io(const std::vector<T>& values) {
+        io(static_cast<std::uint32_t>(values.size()));
+        for (const T& value : values) {
+            io(value);
+        }
+    }
+
+    template <typename T>
+    std::enable_if_t<std::is_class_v<T>> io(const T& value) {
+        transfer(*this, const_cast<T&>(value));  // Writing never modifies value
+    }
+
+    const std::string& buffer() const { return m_buffer; }
+
+private:
+    std::string m_buffer;
+};
+
+// Bounds-checked reader over the mapped payload. Once a read runs past the
+// end every further read is a no-op and ok() stays false.
+class CacheReader {
+public:
+    CacheReader(const char* data, std::size_t size) : m_data(data), m_end(data + size) {}
+
+    template <typename T>
+    std::enable_if_t<std::is_arithmetic_v<T> || std::is_enum_v<T>> io(T& value) {
+        if (take(sizeof(value))) {
+            std::memcpy(&value, m_data - sizeof(value), sizeof(value));
+        }
+    }
+
+    void io(std::string& text) {
+        std::uint32_t length = 0;
+        io(length);
+        if (take(length)) {
+            text.assign(m_data - length, length);
+        }
+    }
+
+    template <typename T>
+    void io(std::vector<T>& values) {
+        std::uint32_t count = 0;
+        io(count);
+        // Every element takes at least one byte, which bounds a corrupt count
+        if (!m_ok || count > static_cast<std::size_t>(m_end - m_data)) {
+            m_ok = false;
+            return;
+        }
+        values.resize(count);
+        for (T& value : values) {
+            io(value);
+        }
+    }
+
+    template <typename T>
+    std::enable_if_t<std::is_class_v<T>> io(T& value) {
+        transfer(*this, value);
+    }
+
+    bool ok() const { return m_ok; }
+    bool atEnd() const { return m_data == m_end; }
+
+private:
+    bool take(std::size_t count) {
+        if (!m_ok || count > static_cast<std::size_t>(m_end - m_data)) {
+            m_ok = false;
+            return false;
+        }
+        m_data += count;
+        return true;
+    }
+
+    const char* m_data;
+    const char* m_end;
+    bool m_ok = true;
+};
+
+// One field list per model type, shared by the writer and the reader so the
+// two can never disagree on the record layout.
+template <typename Archive>
+void transfer(Archive& archive, DBCAttributeValue& value) {
+    archive.io(value.number);
+    archive.io(value.text);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, DBCAttribute& attribute) {
+    archive.io(attribute.name);
+    archive.io(attribute.value);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, DBCAttributeDefinition& definition) {
+    archive.io(definition.name);
+    archive.io(definition.object);
+    archive.io(definition.type);
+    archive.io(definition.minimum);
+    archive.io(definition.maximum);
+    archive.io(definition.enumValues);
+    archive.io(definition.defaultValue);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, DBCValueDescription& description) {
+    archive.io(description.value);
+    archive.io(description.description);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, DBCValueTable& table) {
+    archive.io(table.name);
+    archive.io(table.values);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, DBCMultiplexRange& range) {
+    archive.io(range.low);
+    archive.io(range.high);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, DBCSignal& signal) {
+    archive.io(signal.name);
+    archive.io(signal.startBit);
+    archive.io(signal.bitLength);
+    archive.io(signal.byteOrder);
+    archive.io(signal.isSigned);
+    archive.io(signal.valueType);
+    archive.io(signal.factor);
+    archive.io(signal.offset);
+    archive.io(signal.minimum);
+    archive.io(signal.maximum);
+    archive.io(signal.unit);
+    archive.io(signal.receivers);
+    archive.io(signal.isMultiplexor);
+    archive.io(signal.isMultiplexed);
+    archive.io(signal.multiplexValue);
+    archive.io(signal.multiplexorName);
+    archive.io(signal.multiplexRanges);
+    archive.io(signal.comment);
+    archive.io(signal.valueDescriptions);
+    archive.io(signal.attributes);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, DBCMessage& message) {
+    archive.io(message.id);
+    archive.io(message.extended);
+    archive.io(message.name);
+    archive.io(message.size);
+    archive.io(message.transmitter);
+    archive.io(message.signals);
+    archive.io(message.comment);
+    archive.io(message.attributes);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, DBCEnvironmentVariable& variable) {
+    archive.io(variable.name);
+    archive.io(variable.type);
+    archive.io(variable.minimum);
+    archive.io(variable.maximum);
+    archive.io(variable.unit);
+    archive.io(variable.initialValue);
+    archive.io(variable.id);
+    archive.io(variable.accessType);
+    archive.io(variable.accessNodes);
+    archive.io(variable.dataSize);
+    archive.io(variable.comment);
+    archive.io(variable.valueDescriptions);
+    archive.io(variable.attributes);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, DBCNode& node) {
+    archive.io(node.name);
+    archive.io(node.comment);
+    archive.io(node.attributes);
+}
+
+template <typename Archive>
+void transfer(Archive& archive, DBCDatabase& database) {
+    archive.io(database.version);
+    archive.io(database.comment);
+    archive.io(database.nodes);
+    archive.io(database.messages);
+    archive.io(database.valueTables);
+    archive.io(database.environmentVariables);
+    archive.io(database.attributeDefinitions);
+    archive.io(database.attributes);
+}
+
+} // namespace
+
+std::uint64_t dbcSourceHash(std::string_view text) {
+    // Multiply-xorshift over 8-byte words: several times faster than a
+    // bytewise hash, which matters because every start hashes the whole file
+    constexpr std::uint64_t Multiplier = 0x9E3779B97F4A7C15ULL;
+    std::uint64_t hash = 0xCBF29CE484222325ULL ^ (text.size() * Multiplier);
+    std::size_t pos = 0;
+    for (; pos + 8 <= text.size(); pos += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, text.data() + pos, sizeof(word));
+        hash = (hash ^ word) * Multiplier;
+        hash ^= hash >> 29;
+    }
+    std::uint64_t tail = 0;
+    if (pos < text.size()) {
+        std::memcpy(&tail, text.data() + pos, text.size() - pos);
+    }
+    hash = (hash ^ tail) * Multiplier;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+bool writeDBCCache(const std::string& cachePath, const DBCDatabase& database, std::uint64_t sourceHash,
+                   std::uint64_t sourceSize) {
+    CacheWriter writer;
+    writer.io(database);
+    const std::string& payload = writer.buffer();
+    const CacheHeader header{CacheMagic, DBCCacheFormatVersion, sourceHash, sourceSize, payload.size(),
+                             dbcSourceHash(payload)};
+
+    const std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream output(tempPath, std::ios::binary | std::ios::trunc);
+        output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        output.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+        if (!output) {
+            std::cerr << "Writing DBC cache " << tempPath << " failed!" << std::endl;
+            output.close();
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+    std::remove(cachePath.c_str());  // rename() does not replace on Windows
+    if (std::rename(tempPath.c_str(), cachePath.c_str()) != 0) {
+        std::cerr << "Replacing DBC cache " << cachePath << " failed!" << std::endl;
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool readDBCCache(const std::string& cachePath, std::uint64_t sourceHash, std::uint64_t sourceSize,
+                  DBCDatabase& database) {
+    database = DBCDatabase();
+    if (!std::ifstream(cachePath)) {
+        return false;  // No cache yet; MappedFile would report that as an error
+    }
+    MappedFile file(cachePath);
+    if (!file.isOpen() || file.size() < sizeof(CacheHeader)) {
+        return false;
+    }
+    CacheHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    const char* payload = file.data() + sizeof(header);
+    if (header.magic != CacheMagic || header.formatVersion != DBCCacheFormatVersion
+        || header.sourceHash != sourceHash || header.sourceSize != sourceSize
+        || header.payloadSize != file.size() - sizeof(header)
+        || header.payloadHash != dbcSourceHash(std::string_view(payload, header.payloadSize))) {
+        return false;
+    }
+
+    CacheReader reader(payload, header.payloadSize);
+    reader.io(database);
+    if (!reader.ok() || !reader.atEnd()) {
+        database = DBCDatabase();
+        return false;
+    }
+    database.rebuildIndex();
+    return true;
+}
+
+bool loadDBCFileCached(const std::string& path, DBCDatabase& database, std::string* error) {
+    MappedFile file(path);
+    if (!file.isOpen()) {
+        database = DBCDatabase();
+        if (error != nullptr) {
+            *error = "cannot open " + path;
+        }
+        return false;
+    }
+
+    const std::string cachePath = path + ".cache";
+    const std::uint64_t sourceHash = dbcSourceHash(file.view());
+    if (readDBCCache(cachePath, sourceHash, file.size(), database)) {
+        return true;
+    }
+
+    std::string parseError;
+    if (!parseDBC(file.view(), database, &parseError)) {
+        std::cerr << "Parsing " << path << " failed! " << parseError << std::endl;
+        if (error != nullptr) {
+            *error = std::move(parseError);
+        }
+        return false;
+    }
+    writeDBCCache(cachePath, database, sourceHash, file.size());
+    return true;
+}
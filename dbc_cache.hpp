@@ -0,0 +1,36 @@
+#ifndef DBC_CACHE_HPP
+#define DBC_CACHE_HPP
+
+#include "dbc_database.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Binary cache of a parsed DBC database. The cache file stores the model as
+// length-prefixed records behind a header with the hash and size of the DBC
+// text it was built from; loading it memory-maps the file and copies the
+// records straight into a DBCDatabase without tokenizing anything.
+//
+// Bump DBCCacheFormatVersion whenever the model or the record layout changes,
+// so stale caches are rebuilt instead of misread.
+constexpr std::uint32_t DBCCacheFormatVersion = 2;  // 2: environment variables
+
+// 64-bit hash of the DBC text, the cache key
+std::uint64_t dbcSourceHash(std::string_view text);
+
+// Writes database to cachePath (through a temporary file, so a crash never
+// leaves a truncated cache behind).
+bool writeDBCCache(const std::string& cachePath, const DBCDatabase& database, std::uint64_t sourceHash,
+                   std::uint64_t sourceSize);
+
+// Loads cachePath if it was built from a DBC text with the given hash and
+// size by this format version. Returns false, leaving database empty, otherwise.
+bool readDBCCache(const std::string& cachePath, std::uint64_t sourceHash, std::uint64_t sourceSize,
+                  DBCDatabase& database);
+
+// Drop-in for loadDBCFile: uses "<path>.cache" when it matches the DBC file,
+// otherwise parses the text and refreshes the cache. A cache that cannot be
+// written (read-only directory) only costs the next start a parse.
+bool loadDBCFileCached(const std::string& path, DBCDatabase& database, std::string* error = nullptr);
+
+#endif // DBC_CACHE_HPP
@@ -0,0 +1,274 @@
+// Build-time generator: turns a DBC file into a header with constexpr
+// message/signal descriptors and typed inline decode/encode functions.
+//
+// Usage: dbc_codegen <input.dbc> <output.hpp> <namespace>
+//
+// Every message becomes a struct in the namespace and every signal a nested
+// struct, e.g. AutoDoorLock::CarSpeedValue::Speed::decode(frame). The
+// output file is only rewritten when its content changes.
+
+#include "dbc_bit_codec.hpp"
+#include "dbc_parser.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+
+namespace {
+
+const std::set<std::string> ReservedNames = {
+    // Members of the generated structs
+    "id", "extended", "size", "name", "unit", "startBit", "bitLength", "isSigned", "intel", "factor", "offset",
+    "minimum", "maximum", "isMultiplexor", "isMultiplexed", "multiplexValue", "RawType", "Values",
+    "decode", "decodeRaw", "encode", "encodeRaw",
+    // C++ keywords likely to show up as DBC names
+    "auto", "break", "case", "char", "class", "const", "default", "delete", "do", "double", "else", "enum",
+    "float", "for", "if", "int", "long", "new", "private", "public", "return", "short", "signed", "static",
+    "struct", "switch", "template", "this", "union", "unsigned", "void", "volatile", "while"};
+
+// DBC names are already C identifiers; only collisions need renaming
+std::string identifier(const std::string& name, const std::string& enclosing = {}) {
+    if (name == enclosing || ReservedNames.count(name) != 0) {
+        return name + "_";
+    }
+    return name;
+}
+
+std::string enumerator(const std::string& description) {
+    std::string result;
+    for (char c : description) {
+        const bool valid = (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_';
+        result.push_back(valid ? c : '_');
+    }
+    if (result.empty() || (result[0] >= '0' && result[0] <= '9')) {
+        result.insert(0, "Value_");
+    }
+    return identifier(result);
+}
+
+std::string quoted(const std::string& text) {
+    std::string result = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            result.push_back('\\');
+        }
+        result.push_back(c == '\n' ? ' ' : c);
+    }
+    return result + "\"";
+}
+
+std::string number(double value) {
+    char buffer[32];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    std::string text(buffer, result.ptr);
+    if (text.find_first_of(".en") == std::string::npos) {
+        text += ".0";  // Keep the literal a double
+    }
+    return text;
+}
+
+const char* rawType(const DBCSignal& signal) {
+    const bool fitsSigned = signal.isSigned;
+    if (signal.bitLength <= 8) return fitsSigned ? "std::int8_t" : "std::uint8_t";
+    if (signal.bitLength <= 16) return fitsSigned ? "std::int16_t" : "std::uint16_t";
+    if (signal.bitLength <= 32) return fitsSigned ? "std::int32_t" : "std::uint32_t";
+    return fitsSigned ? "std::int64_t" : "std::uint64_t";
+}
+
+void writeSignal(std::ostream& out, const DBCSignal& signal, const std::string& messageName) {
+    const bool intel = signal.byteOrder == DBCByteOrder::Intel;
+    const DBCBitWindow window = intel ? dbcIntelWindow(signal.startBit, signal.bitLength)
+                                      : dbcMotorolaWindow(signal.startBit, signal.bitLength);
+    const std::string name = identifier(signal.name, messageName);
+    const std::string indent = "        ";
+
+    out << "    struct " << name << " {\n";
+    out << indent << "using RawType = " << rawType(signal) << ";\n";
+    out << indent << "static constexpr const char* name = " << quoted(signal.name) << ";\n";
+    out << indent << "static constexpr std::uint16_t startBit = " << signal.startBit << ";\n";
+    out << indent << "static constexpr std::uint16_t bitLength = " << signal.bitLength << ";\n";
+    out << indent << "static constexpr bool intel = " << (intel ? "true" : "false") << ";\n";
+    out << indent << "static constexpr bool isSigned = " << (signal.isSigned ? "true" : "false") << ";\n";
+    out << indent << "static constexpr double factor = " << number(signal.factor) << ";\n";
+    out << indent << "static constexpr double offset = " << number(signal.offset) << ";\n";
+    out << indent << "static constexpr double minimum = " << number(signal.minimum) << ";\n";
+    out << indent << "static constexpr double maximum = " << number(signal.maximum) << ";\n";
+    out << indent << "static constexpr const char* unit = " << quoted(signal.unit) << ";\n";
+    out << indent << "static constexpr bool isMultiplexor = " << (signal.isMultiplexor ? "true" : "false") << ";\n";
+    out << indent << "static constexpr bool isMultiplexed = " << (signal.isMultiplexed ? "true" : "false") << ";\n";
+    out << indent << "static constexpr std::uint32_t multiplexValue = " << signal.multiplexValue << ";\n";
+
+    // Value descriptions become an enum, unless a value does not fit the signal
+    const unsigned int length = signal.bitLength;
+    const std::int64_t lowest = !signal.isSigned ? 0 : length >= 64 ? INT64_MIN : -(std::int64_t(1) << (length - 1));
+    const std::int64_t highest = signal.isSigned ? (length >= 64 ? INT64_MAX : (std::int64_t(1) << (length - 1)) - 1)
+                                                 : (length >= 63 ? INT64_MAX : (std::int64_t(1) << length) - 1);
+    const bool valuesFit = std::all_of(signal.valueDescriptions.begin(), signal.valueDescriptions.end(),
+                                       [&](const DBCValueDescription& value) { return value.value >= lowest && value.value <= highest; });
+    if (!signal.valueDescriptions.empty() && valuesFit) {
+        std::set<std::string> used;
+        out << "\n" << indent << "enum class Values : " << rawType(signal) << " {\n";
+        for (const DBCValueDescription& value : signal.valueDescriptions) {
+            std::string enumName = enumerator(value.description);
+            while (!used.insert(enumName).second) {
+                enumName += "_";
+            }
+            out << indent << "    " << enumName << " = " << value.value << ",\n";
+        }
+        out << indent << "};\n";
+    }
+
+    // Raw access reads and writes only the bytes the signal occupies
+    out << "\n" << indent << "static constexpr RawType decodeRaw(const std::uint8_t* data) {\n";
+    std::ostringstream extract;
+    if (!window.fits) {
+        extract << "dbcExtractBitsSlow(data, " << signal.startBit << ", " << signal.bitLength << ", "
+                << (intel ? "true" : "false") << ")";
+    } else if (intel) {
+        const unsigned int count = window.requiredBytes - window.byteOffset;
+        extract << "(dbcLoadBytesLittleEndian(data, " << window.byteOffset << ", " << count << ") >> "
+                << static_cast<unsigned int>(window.shift) << ") & dbcBitMask(bitLength)";
+    } else {
+        const unsigned int count = window.requiredBytes - window.byteOffset;
+        const unsigned int shift = count * 8 - (64 - window.shift);  // Window shift relative to count bytes
+        extract << "(dbcLoadBytesBigEndian(data, " << window.byteOffset << ", " << count << ") >> " << shift
+                << ") & dbcBitMask(bitLength)";
+    }
+    if (signal.isSigned) {
+        out << indent << "    return static_cast<RawType>(dbcSignExtend(" << extract.str() << ", bitLength));\n";
+    } else {
+        out << indent << "    return static_cast<RawType>(" << extract.str() << ");\n";
+    }
+    out << indent << "}\n";
+
+    out << indent << "static constexpr void encodeRaw(std::uint8_t* data, RawType raw) {\n";
+    out << indent << "    const std::uint64_t bits = static_cast<std::uint64_t>(raw) & dbcBitMask(bitLength);\n";
+    if (!window.fits) {
+        out << indent << "    dbcInsertBitsSlow(data, startBit, bitLength, intel, bits);\n";
+    } else {
+        const unsigned int count = window.requiredBytes - window.byteOffset;
+        const unsigned int shift = intel ? window.shift : count * 8 - (64 - window.shift);
+        out << indent << "    " << (intel ? "dbcStoreBytesLittleEndian" : "dbcStoreBytesBigEndian") << "(data, "
+            << window.byteOffset << ", " << count << ", bits << " << shift << ", dbcBitMask(bitLength) << " << shift
+            << ");\n";
+    }
+    out << indent << "}\n";
+
+    // Physical access
+    if (signal.valueType == DBCValueType::Float32 && signal.bitLength == 32) {
+        out << indent << "static double decode(const std::uint8_t* data) {\n"
+            << indent << "    const std::uint32_t bits = static_cast<std::uint32_t>(decodeRaw(data));\n"
+            << indent << "    float value;\n"
+            << indent << "    std::memcpy(&value, &bits, sizeof(value));\n"
+            << indent << "    return static_cast<double>(value) * factor + offset;\n"
+            << indent << "}\n"
+            << indent << "static void encode(std::uint8_t* data, double value) {\n"
+            << indent << "    const float scaled = static_cast<float>((value - offset) / factor);\n"
+            << indent << "    std::uint32_t bits;\n"
+            << indent << "    std::memcpy(&bits, &scaled, sizeof(bits));\n"
+            << indent << "    encodeRaw(data, static_cast<RawType>(bits));\n"
+            << indent << "}\n";
+    } else if (signal.valueType == DBCValueType::Float64 && signal.bitLength == 64) {
+        out << indent << "static double decode(const std::uint8_t* data) {\n"
+            << indent << "    const std::uint64_t bits = static_cast<std::uint64_t>(decodeRaw(data));\n"
+            << indent << "    double value;\n"
+            << indent << "    std::memcpy(&value, &bits, sizeof(value));\n"
+            << indent << "    return value * factor + offset;\n"
+            << indent << "}\n"
+            << indent << "static void encode(std::uint8_t* data, double value) {\n"
+            << indent << "    const double scaled = (value - offset) / factor;\n"
+            << indent << "    std::uint64_t bits;\n"
+            << indent << "    std::memcpy(&bits, &scaled, sizeof(bits));\n"
+            << indent << "    encodeRaw(data, static_cast<RawType>(bits));\n"
+            << indent << "}\n";
+    } else {
+        out << indent << "static constexpr double decode(const std::uint8_t* data) {\n"
+            << indent << "    return static_cast<double>(decodeRaw(data)) * factor + offset;\n"
+            << indent << "}\n"
+            << indent << "static void encode(std::uint8_t* data, double value) {\n"
+            << indent << "    encodeRaw(data, static_cast<RawType>(dbcPhysicalToRaw(value, factor, offset, bitLength, isSigned)));\n"
+            << indent << "}\n";
+    }
+
+    // Frame overloads for TPCANMsg, TPCANMsgFD or anything else with a DATA
+    // array; constrained so a plain byte array takes the pointer overloads
+    out << indent << "template <typename Frame> requires requires(const Frame& frame) { frame.DATA; }\n"
+        << indent << "static constexpr double decode(const Frame& frame) { return decode(frame.DATA); }\n"
+        << indent << "template <typename Frame> requires requires(Frame& frame) { frame.DATA; }\n"
+        << indent << "static void encode(Frame& frame, double value) { encode(frame.DATA, value); }\n";
+    out << "    };\n";
+}
+
+void writeMessage(std::ostream& out, const DBCMessage& message) {
+    const std::string name = identifier(message.name);
+    out << "struct " << name << " {\n";
+    out << "    static constexpr const char* name = " << quoted(message.name) << ";\n";
+    out << "    static constexpr std::uint32_t id = 0x" << std::hex << message.id << std::dec << ";\n";
+    out << "    static constexpr bool extended = " << (message.extended ? "true" : "false") << ";\n";
+    out << "    static constexpr std::uint16_t size = " << message.size << ";\n";
+    for (const DBCSignal& signal : message.signals) {
+        out << "\n";
+        writeSignal(out, signal, name);
+    }
+    out << "};\n";
+}
+
+std::string generate(const DBCDatabase& database, const std::string& source, const std::string& nameSpace) {
+    std::string guard = "DBC_" + nameSpace + "_HPP";
+    std::transform(guard.begin(), guard.end(), guard.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+
+    std::ostringstream out;
+    out << "// Generated by dbc_codegen from " << source << ". Do not edit.\n"
+        << "#ifndef " << guard << "\n"
+        << "#define " << guard << "\n\n"
+        << "#include \"dbc_bit_codec.hpp\"\n"
+        << "#include <cstdint>\n"
+        << "#include <cstring>\n\n"
+        << "namespace " << nameSpace << " {\n";
+    for (const DBCMessage& message : database.messages) {
+        out << "\n";
+        writeMessage(out, message);
+    }
+    out << "\n} // namespace " << nameSpace << "\n\n"
+        << "#endif // " << guard << "\n";
+    return out.str();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc != 4) {
+        std::cerr << "Usage: dbc_codegen <input.dbc> <output.hpp> <namespace>" << std::endl;
+        return 2;
+    }
+    const std::string inputPath = argv[1];
+    const std::string outputPath = argv[2];
+
+    DBCDatabase database;
+    if (!loadDBCFile(inputPath, database)) {
+        return 1;
+    }
+    const std::string source = inputPath.substr(inputPath.find_last_of("/\\") + 1);
+    const std::string header = generate(database, source, identifier(argv[3]));
+
+    // Leave the file (and its timestamp) alone if nothing changed
+    std::ifstream existing(outputPath, std::ios::binary);
+    if (existing) {
+        std::ostringstream current;
+        current << existing.rdbuf();
+        if (current.str() == header) {
+            return 0;
+        }
+    }
+    std::ofstream output(outputPath, std::ios::binary | std::ios::trunc);
+    output << header;
+    if (!output) {
+        std::cerr << "Writing " << outputPath << " failed!" << std::endl;
+        return 1;
+    }
+    return 0;
+}
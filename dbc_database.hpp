@@ -0,0 +1,267 @@
+#ifndef DBC_DATABASE_HPP
+#define DBC_DATABASE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// In-memory model of a Vector DBC file, as produced by the DBC parser.
+
+enum class DBCByteOrder : std::uint8_t {
+    Motorola = 0,  // @0, big endian; startBit is the MSB in DBC sawtooth numbering
+    Intel = 1      // @1, little endian; startBit is the LSB
+};
+
+enum class DBCValueType : std::uint8_t {
+    Integer = 0,   // Raw value is an integer (signedness from DBCSignal::isSigned)
+    Float32 = 1,   // SIG_VALTYPE_ 1: IEEE single, bitLength 32
+    Float64 = 2    // SIG_VALTYPE_ 2: IEEE double, bitLength 64
+};
+
+// Object kind an attribute definition applies to (BA_DEF_ [BU_|BO_|SG_|EV_])
+enum class DBCAttributeObject : std::uint8_t {
+    Network,
+    Node,
+    Message,
+    Signal,
+    EnvironmentVariable
+};
+
+enum class DBCAttributeType : std::uint8_t {
+    Int,
+    Hex,
+    Float,
+    String,
+    Enum
+};
+
+// Attribute values are kept both numerically and as text: STRING attributes
+// only use text, ENUM attributes carry the index in number and the label in text.
+struct DBCAttributeValue {
+    double number = 0.0;
+    std::string text;
+};
+
+struct DBCAttributeDefinition {
+    std::string name;
+    DBCAttributeObject object = DBCAttributeObject::Network;
+    DBCAttributeType type = DBCAttributeType::Int;
+    double minimum = 0.0;
+    double maximum = 0.0;
+    std::vector<std::string> enumValues;
+    DBCAttributeValue defaultValue;       // BA_DEF_DEF_
+};
+
+struct DBCAttribute {
+    std::string name;
+    DBCAttributeValue value;
+};
+
+struct DBCValueDescription {
+    std::int64_t value;
+    std::string description;
+};
+
+struct DBCValueTable {
+    std::string name;
+    std::vector<DBCValueDescription> values;
+};
+
+// Inclusive multiplexor value range (SG_MUL_VAL_)
+struct DBCMultiplexRange {
+    std::uint32_t low = 0;
+    std::uint32_t high = 0;
+};
+
+struct DBCSignal {
+    std::string name;
+    std::uint16_t startBit = 0;
+    std::uint16_t bitLength = 0;
+    DBCByteOrder byteOrder = DBCByteOrder::Intel;
+    bool isSigned = false;
+    DBCValueType valueType = DBCValueType::Integer;
+    double factor = 1.0;
+    double offset = 0.0;
+    double minimum = 0.0;
+    double maximum = 0.0;
+    std::string unit;
+    std::vector<std::string> receivers;
+
+    // Multiplexing: "M" marks the multiplexor, "m<n>" a signal that is only
+    // present when the multiplexor equals n. "m<n>M" (extended multiplexing)
+    // sets both flags.
+    bool isMultiplexor = false;
+    bool isMultiplexed = false;
+    std::uint32_t multiplexValue = 0;
+
+    // Extended multiplexing (SG_MUL_VAL_): the multiplexor that selects this
+    // signal and the values that do. When empty, the signal belongs to the
+    // message's top-level multiplexor with the single value multiplexValue.
+    std::string multiplexorName;
+    std::vector<DBCMultiplexRange> multiplexRanges;
+
+    std::string comment;
+    std::vector<DBCValueDescription> valueDescriptions;  // VAL_
+    std::vector<DBCAttribute> attributes;                // BA_ ... SG_
+};
+
+struct DBCMessage {
+    std::uint32_t id = 0;     // CAN identifier without the DBC extended flag
+    bool extended = false;    // Bit 31 of the DBC message ID
+    std::string name;
+    std::uint16_t size = 0;   // Payload length in bytes (up to 64 for CAN FD)
+    std::string transmitter;
+    std::vector<DBCSignal> signals;
+    std::string comment;
+    std::vector<DBCAttribute> attributes;
+
+    // ID as written in the DBC file, i.e. with bit 31 set for extended frames
+    std::uint32_t dbcId() const { return extended ? (id | 0x80000000U) : id; }
+
+    const DBCSignal* findSignal(std::string_view signalName) const {
+        for (const DBCSignal& signal : signals) {
+            if (signal.name == signalName) {
+                return &signal;
+            }
+        }
+        return nullptr;
+    }
+
+    static constexpr int AlwaysPresent = -1;
+    static constexpr int UnknownMultiplexor = -2;
+
+    // Index in signals of the multiplexor that selects signal: the one named
+    // by SG_MUL_VAL_, else the top-level "M" signal for "m<n>" signals.
+    int multiplexorIndex(const DBCSignal& signal) const {
+        if (signal.multiplexorName.empty() && !signal.isMultiplexed) {
+            return AlwaysPresent;
+        }
+        for (std::size_t i = 0; i < signals.size(); ++i) {
+            const DBCSignal& candidate = signals[i];
+            if (signal.multiplexorName.empty() ? (candidate.isMultiplexor && !candidate.isMultiplexed)
+                                               : candidate.name == signal.multiplexorName) {
+                return &candidate != &signal ? static_cast<int>(i) : UnknownMultiplexor;
+            }
+        }
+        return UnknownMultiplexor;
+    }
+};
+
+enum class DBCEnvironmentVariableType : std::uint8_t {
+    Integer = 0,
+    Float = 1,
+    String = 2,
+    Data = 3       // ENVVAR_DATA_/EV_DATA_ byte array
+};
+
+// EV_ name : type [min|max] "unit" initial id access nodes;
+struct DBCEnvironmentVariable {
+    std::string name;
+    DBCEnvironmentVariableType type = DBCEnvironmentVariableType::Integer;
+    double minimum = 0.0;
+    double maximum = 0.0;
+    std::string unit;
+    double initialValue = 0.0;
+    std::uint32_t id = 0;
+    std::uint32_t accessType = 0;         // DUMMY_NODE_VECTOR<n>: 0 unrestricted, 1 read, 2 write, 3 read/write
+    std::vector<std::string> accessNodes;
+    std::uint32_t dataSize = 0;           // Bytes, Data variables only
+    std::string comment;
+    std::vector<DBCValueDescription> valueDescriptions;  // VAL_
+    std::vector<DBCAttribute> attributes;                // BA_ ... EV_
+};
+
+struct DBCNode {
+    std::string name;
+    std::string comment;
+    std::vector<DBCAttribute> attributes;
+};
+
+struct DBCDatabase {
+    std::string version;
+    std::string comment;
+    std::vector<DBCNode> nodes;
+    std::vector<DBCMessage> messages;
+    std::vector<DBCValueTable> valueTables;
+    std::vector<DBCEnvironmentVariable> environmentVariables;
+    std::vector<DBCAttributeDefinition> attributeDefinitions;
+    std::vector<DBCAttribute> attributes;  // Network attributes
+
+    const DBCMessage* findMessage(std::uint32_t id, bool extended) const {
+        auto it = messageIndex.find(extended ? (id | 0x80000000U) : id);
+        return it != messageIndex.end() ? &messages[it->second] : nullptr;
+    }
+
+    const DBCMessage* findMessage(std::string_view name) const {
+        for (const DBCMessage& message : messages) {
+            if (message.name == name) {
+                return &message;
+            }
+        }
+        return nullptr;
+    }
+
+    const DBCEnvironmentVariable* findEnvironmentVariable(std::string_view name) const {
+        for (const DBCEnvironmentVariable& variable : environmentVariables) {
+            if (variable.name == name) {
+                return &variable;
+            }
+        }
+        return nullptr;
+    }
+
+    const DBCAttributeDefinition* findAttributeDefinition(std::string_view name) const {
+        for (const DBCAttributeDefinition& definition : attributeDefinitions) {
+            if (definition.name == name) {
+                return &definition;
+            }
+        }
+        return nullptr;
+    }
+
+    // Value of attribute name on an object: its own BA_ entry, else the
+    // BA_DEF_DEF_ default. nullptr if the attribute is not defined at all.
+    const DBCAttributeValue* attributeValue(const std::vector<DBCAttribute>& objectAttributes,
+                                            std::string_view name) const {
+        for (const DBCAttribute& attribute : objectAttributes) {
+            if (attribute.name == name) {
+                return &attribute.value;
+            }
+        }
+        const DBCAttributeDefinition* definition = findAttributeDefinition(name);
+        return definition != nullptr ? &definition->defaultValue : nullptr;
+    }
+
+    double numericAttribute(const std::vector<DBCAttribute>& objectAttributes, std::string_view name,
+                            double fallback) const {
+        const DBCAttributeValue* value = attributeValue(objectAttributes, name);
+        return value != nullptr ? value->number : fallback;
+    }
+
+    // Transmission period from GenMsgCycleTime; 0 if the message is not
+    // sent cyclically (no cycle time, or a GenMsgSendType other than cyclic)
+    std::uint32_t messageCycleTimeMs(const DBCMessage& message) const {
+        const DBCAttributeValue* sendType = attributeValue(message.attributes, "GenMsgSendType");
+        if (sendType != nullptr && !sendType->text.empty() && sendType->text.find("yclic") == std::string::npos) {
+            return 0;  // e.g. "Event", "NoMsgSendType"; "Cyclic", "cyclicIfActive" and friends keep the period
+        }
+        const double cycleTime = numericAttribute(message.attributes, "GenMsgCycleTime", 0.0);
+        return cycleTime > 0.0 ? static_cast<std::uint32_t>(cycleTime) : 0;
+    }
+
+    // Must be called after messages changes; the parser does so before returning
+    void rebuildIndex() {
+        messageIndex.clear();
+        messageIndex.reserve(messages.size());
+        for (std::size_t i = 0; i < messages.size(); ++i) {
+            messageIndex[messages[i].dbcId()] = i;
+        }
+    }
+
+    std::unordered_map<std::uint32_t, std::size_t> messageIndex;  // dbcId() -> messages index
+};
+
+#endif // DBC_DATABASE_HPP
@@ -0,0 +1,32 @@
+// Compiles the generated DBC headers into the application, so a broken
+// dbc_codegen or a signal renamed in dbc/ fails the build instead of
+// surfacing as a runtime lookup miss.
+#include "dbc/AutoDoorLock.hpp"
+#include "PCANBasic.h"
+
+namespace {
+
+constexpr bool carSpeedRoundTrips() {
+    std::uint8_t data[AutoDoorLock::CarSpeedValue::size] = {};
+    AutoDoorLock::CarSpeedValue::Speed::encodeRaw(data, 123);
+    AutoDoorLock::DoorLockStatus::DoorLock::encodeRaw(data + 1, 1);
+    return AutoDoorLock::CarSpeedValue::Speed::decodeRaw(data) == 123
+        && AutoDoorLock::CarSpeedValue::Speed::decode(data) == 123.0
+        && AutoDoorLock::DoorLockStatus::DoorLock::decodeRaw(data + 1) == 1
+        && data[0] == 123 && data[2] == 0;
+}
+
+static_assert(AutoDoorLock::CarSpeedValue::id == 0x1 && !AutoDoorLock::CarSpeedValue::extended,
+              "CarSpeedValue descriptor");
+static_assert(AutoDoorLock::DoorLockStatus::DoorLock::bitLength == 1, "DoorLock descriptor");
+
+constexpr bool decodesFromFrame() {
+    TPCANMsg frame{};
+    frame.DATA[0] = 88;
+    return AutoDoorLock::CarSpeedValue::Speed::decode(frame) == 88.0;
+}
+
+static_assert(carSpeedRoundTrips(), "generated accessors must encode and decode in constant expressions");
+static_assert(decodesFromFrame(), "generated accessors must take PCAN frames");
+
+} // namespace
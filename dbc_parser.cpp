@@ -0,0 +1,897 @@
+#include "dbc_parser.hpp"
+#include "mapped_file.hpp"
+#include <charconv>
+#include <iostream>
+
+namespace {
+
+constexpr std::string_view IndependentSignalsMessage = "VECTOR__INDEPENDENT_SIG_MSG";
+
+enum class TokenType {
+    End,
+    Identifier,
+    Number,
+    String,       // Text between the quotes, escapes not yet resolved
+    Punctuation   // A single character
+};
+
+struct Token {
+    TokenType type = TokenType::End;
+    std::string_view text;
+
+    bool is(char c) const { return type == TokenType::Punctuation && text[0] == c; }
+    bool is(std::string_view keyword) const { return type == TokenType::Identifier && text == keyword; }
+};
+
+bool isDigit(char c) { return c >= '0' && c <= '9'; }
+bool isIdentifierStart(char c) { return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || c == '_'; }
+bool isIdentifierChar(char c) { return isIdentifierStart(c) || isDigit(c); }
+
+class DBCTokenizer {
+public:
+    explicit DBCTokenizer(std::string_view text) : m_text(text) {}
+
+    Token next() {
+        skipWhitespace();
+        Token token;
+        if (m_pos >= m_text.size()) {
+            return token;
+        }
+
+        const std::size_t start = m_pos;
+        const char c = m_text[m_pos];
+        if (isIdentifierStart(c)) {
+            while (m_pos < m_text.size() && isIdentifierChar(m_text[m_pos])) {
+                ++m_pos;
+            }
+            token.type = TokenType::Identifier;
+        } else if (isNumberStart()) {
+            ++m_pos;
+            while (m_pos < m_text.size()) {
+                const char d = m_text[m_pos];
+                if (isDigit(d) || d == '.') {
+                    ++m_pos;
+                } else if (d == 'e' || d == 'E') {
+                    ++m_pos;
+                    if (m_pos < m_text.size() && (m_text[m_pos] == '+' || m_text[m_pos] == '-')) {
+                        ++m_pos;
+                    }
+                } else {
+                    break;
+                }
+            }
+            token.type = TokenType::Number;
+        } else if (c == '"') {
+            const std::size_t textStart = ++m_pos;
+            while (m_pos < m_text.size() && m_text[m_pos] != '"') {
+                if (m_text[m_pos] == '\\' && m_pos + 1 < m_text.size()) {
+                    ++m_pos;  // Skip the escaped character
+                }
+                if (m_text[m_pos] == '\n') {
+                    ++m_line;
+                }
+                ++m_pos;
+            }
+            token.type = TokenType::String;
+            token.text = m_text.substr(textStart, m_pos - textStart);
+            if (m_pos < m_text.size()) {
+                ++m_pos;  // Closing quote
+            }
+            return token;
+        } else {
+            ++m_pos;
+            token.type = TokenType::Punctuation;
+        }
+        token.text = m_text.substr(start, m_pos - start);
+        return token;
+    }
+
+    Token peek() {
+        const std::size_t pos = m_pos;
+        const std::size_t line = m_line;
+        Token token = next();
+        m_pos = pos;
+        m_line = line;
+        return token;
+    }
+
+    // True when only blanks remain on the current line. Receiver and node
+    // lists are terminated by the line end rather than by ';'.
+    bool atLineEnd() {
+        while (m_pos < m_text.size() && (m_text[m_pos] == ' ' || m_text[m_pos] == '\t' || m_text[m_pos] == '\r')) {
+            ++m_pos;
+        }
+        return m_pos >= m_text.size() || m_text[m_pos] == '\n';
+    }
+
+    void skipLine() {
+        while (m_pos < m_text.size() && m_text[m_pos] != '\n') {
+            ++m_pos;
+        }
+    }
+
+    // Skips the rest of the current line and every following line that is
+    // blank or indented (the NS_ symbol list).
+    void skipIndentedBlock() {
+        skipLine();
+        while (m_pos < m_text.size()) {
+            ++m_pos;  // '\n'
+            ++m_line;
+            if (m_pos < m_text.size() && !isBlank(m_text[m_pos])) {
+                break;
+            }
+            skipLine();
+        }
+    }
+
+    std::size_t line() const { return m_line; }
+
+private:
+    static bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+    void skipWhitespace() {
+        while (m_pos < m_text.size() && isBlank(m_text[m_pos])) {
+            if (m_text[m_pos] == '\n') {
+                ++m_line;
+            }
+            ++m_pos;
+        }
+    }
+
+    bool isNumberStart() const {
+        const char c = m_text[m_pos];
+        if (isDigit(c)) {
+            return true;
+        }
+        if ((c == '-' || c == '+' || c == '.') && m_pos + 1 < m_text.size()) {
+            const char d = m_text[m_pos + 1];
+            return isDigit(d) || (d == '.' && c != '.');
+        }
+        return false;
+    }
+
+    std::string_view m_text;
+    std::size_t m_pos = 0;
+    std::size_t m_line = 1;
+};
+
+std::string unescape(std::string_view text) {
+    if (text.find('\\') == std::string_view::npos) {
+        return std::string(text);
+    }
+    std::string result;
+    result.reserve(text.size());
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '\\' && i + 1 < text.size()) {
+            ++i;
+        }
+        result.push_back(text[i]);
+    }
+    return result;
+}
+
+class DBCParser {
+public:
+    DBCParser(std::string_view text, DBCDatabase& database) : m_tokens(text), m_db(database) {}
+
+    bool parse();
+    const std::string& error() const { return m_error; }
+
+private:
+    bool fail(const std::string& reason);
+    bool expect(char c);
+    bool readIdentifier(std::string_view& value);
+    bool readString(std::string& value);
+    template <typename T> bool readNumber(T& value);
+    template <typename T> bool toNumber(const Token& token, T& value);
+    bool skipStatement();
+
+    bool parseNodes();
+    bool parseMessage();
+    bool parseSignal();
+    bool parseMultiplexIndicator(std::string_view text, DBCSignal& signal);
+    bool parseComment();
+    bool parseValueDescriptions();
+    bool parseValueTable();
+    bool parseValueList(std::vector<DBCValueDescription>* values);
+    bool parseSignalValueType();
+    bool parseMultiplexValues();
+    bool parseEnvironmentVariable();
+    bool parseEnvironmentVariableData();
+    bool parseAttributeDefinition();
+    bool parseAttributeDefault();
+    bool parseAttribute();
+    bool readAttributeValue(std::string_view name, DBCAttributeValue& value);
+
+    DBCMessage* findMessage(std::uint32_t dbcId);
+    DBCSignal* findSignal(std::uint32_t dbcId, std::string_view name);
+    DBCNode* findNode(std::string_view name);
+    DBCEnvironmentVariable* findEnvironmentVariable(std::string_view name);
+    const DBCAttributeDefinition* findAttributeDefinition(std::string_view name) const;
+
+    DBCTokenizer m_tokens;
+    DBCDatabase& m_db;
+    std::string m_error;
+    bool m_inMessage = false;  // SG_ lines attach to the last BO_
+};
+
+bool DBCParser::parse() {
+    for (;;) {
+        const Token token = m_tokens.next();
+        if (token.type == TokenType::End) {
+            break;
+        }
+        if (token.type != TokenType::Identifier) {
+            return fail("expected a section keyword");
+        }
+
+        // Ordered by how often the keywords occur in a typical file
+        const std::string_view keyword = token.text;
+        bool ok = true;
+        if (keyword == "SG_") {
+            ok = parseSignal();
+        } else if (keyword == "BO_") {
+            ok = parseMessage();
+        } else if (keyword == "BA_") {
+            ok = parseAttribute();
+        } else if (keyword == "VAL_") {
+            ok = parseValueDescriptions();
+        } else if (keyword == "CM_") {
+            ok = parseComment();
+        } else if (keyword == "SIG_VALTYPE_") {
+            ok = parseSignalValueType();
+        } else if (keyword == "SG_MUL_VAL_") {
+            ok = parseMultiplexValues();
+        } else if (keyword == "EV_") {
+            ok = parseEnvironmentVariable();
+        } else if (keyword == "ENVVAR_DATA_" || keyword == "EV_DATA_") {
+            ok = parseEnvironmentVariableData();
+        } else if (keyword == "BA_DEF_") {
+            ok = parseAttributeDefinition();
+        } else if (keyword == "BA_DEF_DEF_") {
+            ok = parseAttributeDefault();
+        } else if (keyword == "VAL_TABLE_") {
+            ok = parseValueTable();
+        } else if (keyword == "BU_") {
+            ok = parseNodes();
+        } else if (keyword == "VERSION") {
+            ok = readString(m_db.version);
+        } else if (keyword == "NS_") {
+            m_tokens.skipIndentedBlock();
+        } else if (keyword == "BS_") {
+            m_tokens.skipLine();
+        } else {
+            ok = skipStatement();
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    m_db.rebuildIndex();
+    return true;
+}
+
+bool DBCParser::fail(const std::string& reason) {
+    m_error = "line " + std::to_string(m_tokens.line()) + ": " + reason;
+    return false;
+}
+
+bool DBCParser::expect(char c) {
+    if (!m_tokens.next().is(c)) {
+        return fail(std::string("expected '") + c + "'");
+    }
+    return true;
+}
+
+bool DBCParser::readIdentifier(std::string_view& value) {
+    const Token token = m_tokens.next();
+    if (token.type != TokenType::Identifier) {
+        return fail("expected an identifier");
+    }
+    value = token.text;
+    return true;
+}
+
+bool DBCParser::readString(std::string& value) {
+    const Token token = m_tokens.next();
+    if (token.type != TokenType::String) {
+        return fail("expected a quoted string");
+    }
+    value = unescape(token.text);
+    return true;
+}
+
+template <typename T>
+bool DBCParser::toNumber(const Token& token, T& value) {
+    if (token.type != TokenType::Number) {
+        return fail("expected a number");
+    }
+    std::string_view text = token.text;
+    if (text[0] == '+') {
+        text.remove_prefix(1);  // from_chars does not accept an explicit plus sign
+    }
+    const auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (result.ec != std::errc() || result.ptr != text.data() + text.size()) {
+        return fail("invalid number");
+    }
+    return true;
+}
+
+template <typename T>
+bool DBCParser::readNumber(T& value) {
+    return toNumber(m_tokens.next(), value);
+}
+
+bool DBCParser::skipStatement() {
+    for (;;) {
+        const Token token = m_tokens.next();
+        if (token.type == TokenType::End) {
+            return fail("unterminated statement");
+        }
+        if (token.is(';')) {
+            return true;
+        }
+    }
+}
+
+// BU_: node node ...
+bool DBCParser::parseNodes() {
+    if (!expect(':')) {
+        return false;
+    }
+    while (!m_tokens.atLineEnd()) {
+        std::string_view name;
+        if (!readIdentifier(name)) {
+            return false;
+        }
+        m_db.nodes.push_back(DBCNode{std::string(name), {}, {}});
+    }
+    return true;
+}
+
+// BO_ id name: size transmitter
+bool DBCParser::parseMessage() {
+    std::uint32_t dbcId = 0;
+    std::string_view name;
+    std::uint16_t size = 0;
+    if (!readNumber(dbcId) || !readIdentifier(name) || !expect(':') || !readNumber(size)) {
+        return false;
+    }
+    std::string_view transmitter;
+    if (!m_tokens.atLineEnd() && !readIdentifier(transmitter)) {
+        return false;
+    }
+
+    // Pseudo message collecting signals not assigned to any frame
+    if (name == IndependentSignalsMessage) {
+        m_inMessage = false;
+        return true;
+    }
+    if (m_db.messageIndex.count(dbcId) != 0) {
+        return fail("duplicate message ID");
+    }
+
+    DBCMessage message;
+    message.id = dbcId & 0x7FFFFFFFU;
+    message.extended = (dbcId & 0x80000000U) != 0;
+    message.name = std::string(name);
+    message.size = size;
+    message.transmitter = std::string(transmitter);
+    m_db.messageIndex.emplace(dbcId, m_db.messages.size());
+    m_db.messages.push_back(std::move(message));
+    m_inMessage = true;
+    return true;
+}
+
+// SG_ name [M|m<n>|m<n>M] : start|length@order sign (factor,offset) [min|max] "unit" receivers
+bool DBCParser::parseSignal() {
+    DBCSignal signal;
+    std::string_view name;
+    if (!readIdentifier(name)) {
+        return false;
+    }
+    signal.name = std::string(name);
+
+    Token token = m_tokens.next();
+    if (token.type == TokenType::Identifier) {
+        if (!parseMultiplexIndicator(token.text, signal)) {
+            return false;
+        }
+        token = m_tokens.next();
+    }
+    if (!token.is(':')) {
+        return fail("expected ':'");
+    }
+
+    if (!readNumber(signal.startBit) || !expect('|') || !readNumber(signal.bitLength) || !expect('@')) {
+        return false;
+    }
+    const Token byteOrder = m_tokens.next();
+    if (byteOrder.type != TokenType::Number || (byteOrder.text != "0" && byteOrder.text != "1")) {
+        return fail("expected byte order 0 or 1");
+    }
+    signal.byteOrder = byteOrder.text == "1" ? DBCByteOrder::Intel : DBCByteOrder::Motorola;
+    const Token sign = m_tokens.next();
+    if (!sign.is('+') && !sign.is('-')) {
+        return fail("expected value type '+' or '-'");
+    }
+    signal.isSigned = sign.is('-');
+
+    if (!expect('(') || !readNumber(signal.factor) || !expect(',') || !readNumber(signal.offset) || !expect(')')
+        || !expect('[') || !readNumber(signal.minimum) || !expect('|') || !readNumber(signal.maximum) || !expect(']')
+        || !readString(signal.unit)) {
+        return false;
+    }
+    while (!m_tokens.atLineEnd()) {
+        const Token receiver = m_tokens.next();
+        if (receiver.type == TokenType::Identifier) {
+            signal.receivers.emplace_back(receiver.text);
+        } else if (!receiver.is(',')) {
+            return fail("expected a receiver node");
+        }
+    }
+
+    if (signal.bitLength == 0 || signal.bitLength > 64) {
+        return fail("signal length must be 1..64 bits");
+    }
+    if (signal.startBit >= 512) {
+        return fail("signal start bit beyond 64 bytes");
+    }
+    if (m_inMessage) {
+        m_db.messages.back().signals.push_back(std::move(signal));
+    }
+    return true;
+}
+
+bool DBCParser::parseMultiplexIndicator(std::string_view text, DBCSignal& signal) {
+    if (text == "M") {
+        signal.isMultiplexor = true;
+        return true;
+    }
+    if (text.size() < 2 || text[0] != 'm') {
+        return fail("invalid multiplexer indicator");
+    }
+    text.remove_prefix(1);
+    if (text.back() == 'M') {
+        signal.isMultiplexor = true;  // Extended multiplexing: multiplexed and multiplexor at once
+        text.remove_suffix(1);
+    }
+    const auto result = std::from_chars(text.data(), text.data() + text.size(), signal.multiplexValue);
+    if (text.empty() || result.ec != std::errc() || result.ptr != text.data() + text.size()) {
+        return fail("invalid multiplexer indicator");
+    }
+    signal.isMultiplexed = true;
+    return true;
+}
+
+// CM_ [BU_ node | BO_ id | SG_ id signal | EV_ name] "text";
+bool DBCParser::parseComment() {
+    const Token token = m_tokens.next();
+    std::string text;
+    if (token.type == TokenType::String) {
+        m_db.comment = unescape(token.text);
+    } else if (token.is("BU_")) {
+        std::string_view name;
+        if (!readIdentifier(name) || !readString(text)) {
+            return false;
+        }
+        if (DBCNode* node = findNode(name)) {
+            node->comment = std::move(text);
+        }
+    } else if (token.is("BO_")) {
+        std::uint32_t dbcId = 0;
+        if (!readNumber(dbcId) || !readString(text)) {
+            return false;
+        }
+        if (DBCMessage* message = findMessage(dbcId)) {
+            message->comment = std::move(text);
+        }
+    } else if (token.is("SG_")) {
+        std::uint32_t dbcId = 0;
+        std::string_view name;
+        if (!readNumber(dbcId) || !readIdentifier(name) || !readString(text)) {
+            return false;
+        }
+        if (DBCSignal* signal = findSignal(dbcId, name)) {
+            signal->comment = std::move(text);
+        }
+    } else if (token.is("EV_")) {
+        std::string_view name;
+        if (!readIdentifier(name) || !readString(text)) {
+            return false;
+        }
+        if (DBCEnvironmentVariable* variable = findEnvironmentVariable(name)) {
+            variable->comment = std::move(text);
+        }
+    } else {
+        return skipStatement();  // Other objects are not modelled
+    }
+    return expect(';');
+}
+
+// VAL_ id signal value "text" ... ;   or   VAL_ variable value "text" ... ;
+bool DBCParser::parseValueDescriptions() {
+    const Token token = m_tokens.next();
+    if (token.type == TokenType::Identifier) {
+        DBCEnvironmentVariable* variable = findEnvironmentVariable(token.text);
+        return parseValueList(variable != nullptr ? &variable->valueDescriptions : nullptr);
+    }
+    std::uint32_t dbcId = 0;
+    std::string_view name;
+    if (!toNumber(token, dbcId) || !readIdentifier(name)) {
+        return false;
+    }
+    DBCSignal* signal = findSignal(dbcId, name);
+    return parseValueList(signal != nullptr ? &signal->valueDescriptions : nullptr);
+}
+
+// VAL_TABLE_ name value "text" ... ;
+bool DBCParser::parseValueTable() {
+    std::string_view name;
+    if (!readIdentifier(name)) {
+        return false;
+    }
+    m_db.valueTables.push_back(DBCValueTable{std::string(name), {}});
+    return parseValueList(&m_db.valueTables.back().values);
+}
+
+bool DBCParser::parseValueList(std::vector<DBCValueDescription>* values) {
+    for (;;) {
+        const Token token = m_tokens.next();
+        if (token.is(';')) {
+            return true;
+        }
+        DBCValueDescription description{0, {}};
+        if (!toNumber(token, description.value) || !readString(description.description)) {
+            return false;
+        }
+        if (values != nullptr) {
+            values->push_back(std::move(description));
+        }
+    }
+}
+
+// SIG_VALTYPE_ id signal : 1|2;
+bool DBCParser::parseSignalValueType() {
+    std::uint32_t dbcId = 0;
+    std::string_view name;
+    int type = 0;
+    if (!readNumber(dbcId) || !readIdentifier(name) || !expect(':') || !readNumber(type) || !expect(';')) {
+        return false;
+    }
+    if (type < 0 || type > 2) {
+        return fail("invalid signal value type");
+    }
+    if (DBCSignal* signal = findSignal(dbcId, name)) {
+        signal->valueType = static_cast<DBCValueType>(type);
+    }
+    return true;
+}
+
+// SG_MUL_VAL_ id signal multiplexor low-high, low-high ... ;
+bool DBCParser::parseMultiplexValues() {
+    std::uint32_t dbcId = 0;
+    std::string_view name;
+    std::string_view multiplexor;
+    if (!readNumber(dbcId) || !readIdentifier(name) || !readIdentifier(multiplexor)) {
+        return false;
+    }
+    std::vector<DBCMultiplexRange> ranges;
+    for (;;) {
+        Token token = m_tokens.next();
+        if (token.is(';')) {
+            break;
+        }
+        if (token.is(',')) {
+            continue;
+        }
+        DBCMultiplexRange range;
+        if (!toNumber(token, range.low)) {
+            return false;
+        }
+        // "3-5" tokenizes as 3 and -5, "3 - 5" as 3, '-' and 5
+        token = m_tokens.next();
+        if (token.is('-')) {
+            token = m_tokens.next();
+        } else if (token.type == TokenType::Number && token.text[0] == '-') {
+            token.text.remove_prefix(1);
+        } else {
+            return fail("expected a multiplexor value range");
+        }
+        if (!toNumber(token, range.high)) {
+            return false;
+        }
+        if (range.high < range.low) {
+            return fail("empty multiplexor value range");
+        }
+        ranges.push_back(range);
+    }
+    if (DBCSignal* signal = findSignal(dbcId, name)) {
+        signal->multiplexorName = std::string(multiplexor);
+        signal->multiplexRanges = std::move(ranges);
+    }
+    return true;
+}
+
+// EV_ name : type [min|max] "unit" initial id DUMMY_NODE_VECTOR<n> node, node ... ;
+bool DBCParser::parseEnvironmentVariable() {
+    DBCEnvironmentVariable variable;
+    std::string_view name;
+    std::uint32_t type = 0;
+    if (!readIdentifier(name) || !expect(':') || !readNumber(type) || !expect('[')
+        || !readNumber(variable.minimum) || !expect('|') || !readNumber(variable.maximum) || !expect(']')
+        || !readString(variable.unit) || !readNumber(variable.initialValue) || !readNumber(variable.id)) {
+        return false;
+    }
+    if (type > 2) {
+        return fail("invalid environment variable type");
+    }
+    variable.name = std::string(name);
+    variable.type = static_cast<DBCEnvironmentVariableType>(type);
+
+    // DUMMY_NODE_VECTOR<n>, n in hex; bit 15 (DUMMY_NODE_VECTOR8000) marks a string variable
+    std::string_view access;
+    if (!readIdentifier(access)) {
+        return false;
+    }
+    constexpr std::string_view AccessPrefix = "DUMMY_NODE_VECTOR";
+    if (access.compare(0, AccessPrefix.size(), AccessPrefix) == 0) {
+        access.remove_prefix(AccessPrefix.size());
+        std::uint32_t accessBits = 0;
+        std::from_chars(access.data(), access.data() + access.size(), accessBits, 16);
+        variable.accessType = accessBits & 0x3;
+        if (accessBits & 0x8000) {
+            variable.type = DBCEnvironmentVariableType::String;
+        }
+    }
+
+    for (;;) {
+        const Token token = m_tokens.next();
+        if (token.is(';')) {
+            break;
+        }
+        if (token.is(',')) {
+            continue;
+        }
+        if (token.type != TokenType::Identifier) {
+            return fail("expected an access node");
+        }
+        if (token.text != "Vector__XXX") {
+            variable.accessNodes.emplace_back(token.text);
+        }
+    }
+    m_db.environmentVariables.push_back(std::move(variable));
+    return true;
+}
+
+// ENVVAR_DATA_ name : size;
+bool DBCParser::parseEnvironmentVariableData() {
+    std::string_view name;
+    std::uint32_t size = 0;
+    if (!readIdentifier(name) || !expect(':') || !readNumber(size) || !expect(';')) {
+        return false;
+    }
+    if (DBCEnvironmentVariable* variable = findEnvironmentVariable(name)) {
+        variable->type = DBCEnvironmentVariableType::Data;
+        variable->dataSize = size;
+    }
+    return true;
+}
+
+// BA_DEF_ [BU_|BO_|SG_|EV_] "name" INT|HEX|FLOAT min max | STRING | ENUM "a","b",... ;
+bool DBCParser::parseAttributeDefinition() {
+    DBCAttributeDefinition definition;
+    Token token = m_tokens.next();
+    if (token.type == TokenType::Identifier) {
+        if (token.text == "BU_") {
+            definition.object = DBCAttributeObject::Node;
+        } else if (token.text == "BO_") {
+            definition.object = DBCAttributeObject::Message;
+        } else if (token.text == "SG_") {
+            definition.object = DBCAttributeObject::Signal;
+        } else if (token.text == "EV_") {
+            definition.object = DBCAttributeObject::EnvironmentVariable;
+        } else {
+            return fail("invalid attribute object type");
+        }
+        token = m_tokens.next();
+    }
+    if (token.type != TokenType::String) {
+        return fail("expected an attribute name");
+    }
+    definition.name = unescape(token.text);
+
+    std::string_view type;
+    if (!readIdentifier(type)) {
+        return false;
+    }
+    if (type == "INT" || type == "HEX" || type == "FLOAT") {
+        definition.type = type == "INT" ? DBCAttributeType::Int
+                        : type == "HEX" ? DBCAttributeType::Hex : DBCAttributeType::Float;
+        if (!m_tokens.peek().is(';') && (!readNumber(definition.minimum) || !readNumber(definition.maximum))) {
+            return false;
+        }
+    } else if (type == "STRING") {
+        definition.type = DBCAttributeType::String;
+    } else if (type == "ENUM") {
+        definition.type = DBCAttributeType::Enum;
+        while (!m_tokens.peek().is(';')) {
+            token = m_tokens.next();
+            if (token.type == TokenType::String) {
+                definition.enumValues.push_back(unescape(token.text));
+            } else if (!token.is(',')) {
+                return fail("expected an enum value");
+            }
+        }
+    } else {
+        return fail("invalid attribute value type");
+    }
+    if (!expect(';')) {
+        return false;
+    }
+    m_db.attributeDefinitions.push_back(std::move(definition));
+    return true;
+}
+
+// BA_DEF_DEF_ "name" value;
+bool DBCParser::parseAttributeDefault() {
+    std::string name;
+    if (!readString(name)) {
+        return false;
+    }
+    DBCAttributeValue value;
+    if (!readAttributeValue(name, value) || !expect(';')) {
+        return false;
+    }
+    for (DBCAttributeDefinition& definition : m_db.attributeDefinitions) {
+        if (definition.name == name) {
+            definition.defaultValue = std::move(value);
+        }
+    }
+    return true;
+}
+
+// BA_ "name" [BU_ node | BO_ id | SG_ id signal | EV_ name] value;
+bool DBCParser::parseAttribute() {
+    std::string name;
+    if (!readString(name)) {
+        return false;
+    }
+    std::vector<DBCAttribute>* target = &m_db.attributes;
+    const Token token = m_tokens.peek();
+    if (token.is("BU_")) {
+        m_tokens.next();
+        std::string_view nodeName;
+        if (!readIdentifier(nodeName)) {
+            return false;
+        }
+        DBCNode* node = findNode(nodeName);
+        target = node != nullptr ? &node->attributes : nullptr;
+    } else if (token.is("BO_")) {
+        m_tokens.next();
+        std::uint32_t dbcId = 0;
+        if (!readNumber(dbcId)) {
+            return false;
+        }
+        DBCMessage* message = findMessage(dbcId);
+        target = message != nullptr ? &message->attributes : nullptr;
+    } else if (token.is("SG_")) {
+        m_tokens.next();
+        std::uint32_t dbcId = 0;
+        std::string_view signalName;
+        if (!readNumber(dbcId) || !readIdentifier(signalName)) {
+            return false;
+        }
+        DBCSignal* signal = findSignal(dbcId, signalName);
+        target = signal != nullptr ? &signal->attributes : nullptr;
+    } else if (token.is("EV_")) {
+        m_tokens.next();
+        std::string_view variableName;
+        if (!readIdentifier(variableName)) {
+            return false;
+        }
+        DBCEnvironmentVariable* variable = findEnvironmentVariable(variableName);
+        target = variable != nullptr ? &variable->attributes : nullptr;
+    }
+
+    DBCAttribute attribute{std::move(name), {}};
+    if (!readAttributeValue(attribute.name, attribute.value) || !expect(';')) {
+        return false;
+    }
+    if (target != nullptr) {
+        target->push_back(std::move(attribute));
+    }
+    return true;
+}
+
+// Reads a number or string and fills in the other representation for enums
+bool DBCParser::readAttributeValue(std::string_view name, DBCAttributeValue& value) {
+    const Token token = m_tokens.next();
+    if (token.type == TokenType::String) {
+        value.text = unescape(token.text);
+    } else if (!toNumber(token, value.number)) {
+        return false;
+    }
+
+    const DBCAttributeDefinition* definition = findAttributeDefinition(name);
+    if (definition == nullptr || definition->type != DBCAttributeType::Enum) {
+        return true;
+    }
+    if (token.type == TokenType::String) {
+        for (std::size_t i = 0; i < definition->enumValues.size(); ++i) {
+            if (definition->enumValues[i] == value.text) {
+                value.number = static_cast<double>(i);
+            }
+        }
+    } else if (value.number >= 0 && value.number < static_cast<double>(definition->enumValues.size())) {
+        value.text = definition->enumValues[static_cast<std::size_t>(value.number)];
+    }
+    return true;
+}
+
+DBCMessage* DBCParser::findMessage(std::uint32_t dbcId) {
+    auto it = m_db.messageIndex.find(dbcId);
+    return it != m_db.messageIndex.end() ? &m_db.messages[it->second] : nullptr;
+}
+
+DBCSignal* DBCParser::findSignal(std::uint32_t dbcId, std::string_view name) {
+    DBCMessage* message = findMessage(dbcId);
+    return message != nullptr ? const_cast<DBCSignal*>(message->findSignal(name)) : nullptr;
+}
+
+DBCNode* DBCParser::findNode(std::string_view name) {
+    for (DBCNode& node : m_db.nodes) {
+        if (node.name == name) {
+            return &node;
+        }
+    }
+    return nullptr;
+}
+
+DBCEnvironmentVariable* DBCParser::findEnvironmentVariable(std::string_view name) {
+    return const_cast<DBCEnvironmentVariable*>(m_db.findEnvironmentVariable(name));
+}
+
+const DBCAttributeDefinition* DBCParser::findAttributeDefinition(std::string_view name) const {
+    for (const DBCAttributeDefinition& definition : m_db.attributeDefinitions) {
+        if (definition.name == name) {
+            return &definition;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+bool parseDBC(std::string_view text, DBCDatabase& database, std::string* error) {
+    database = DBCDatabase();
+    DBCParser parser(text, database);
+    if (!parser.parse()) {
+        database = DBCDatabase();
+        if (error != nullptr) {
+            *error = parser.error();
+        }
+        return false;
+    }
+    return true;
+}
+
+bool loadDBCFile(const std::string& path, DBCDatabase& database, std::string* error) {
+    MappedFile file(path);
+    if (!file.isOpen()) {
+        database = DBCDatabase();
+        if (error != nullptr) {
+            *error = "cannot open " + path;
+        }
+        return false;
+    }
+    std::string parseError;
+    if (!parseDBC(file.view(), database, &parseError)) {
+        std::cerr << "Parsing " << path << " failed! " << parseError << std::endl;
+        if (error != nullptr) {
+            *error = std::move(parseError);
+        }
+        return false;
+    }
+    return true;
+}
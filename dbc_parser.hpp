@@ -0,0 +1,21 @@
+#ifndef DBC_PARSER_HPP
+#define DBC_PARSER_HPP
+
+#include "dbc_database.hpp"
+#include <string>
+#include <string_view>
+
+// Single-pass DBC parser. The tokenizer hands out string_views into the
+// input text, so the only allocations are the strings stored in the model.
+//
+// Supported: VERSION, BU_, BO_, SG_ (including multiplexor indicators),
+// SG_MUL_VAL_, EV_, ENVVAR_DATA_, CM_, VAL_, VAL_TABLE_, SIG_VALTYPE_,
+// BA_DEF_, BA_DEF_DEF_ and BA_.
+// Other sections are skipped. On failure database is left empty and error
+// (if given) receives "line N: <reason>".
+bool parseDBC(std::string_view text, DBCDatabase& database, std::string* error = nullptr);
+
+// Memory-maps path and parses it with parseDBC.
+bool loadDBCFile(const std::string& path, DBCDatabase& database, std::string* error = nullptr);
+
+#endif // DBC_PARSER_HPP
@@ -0,0 +1,34 @@
+#include "dbc_schedule.hpp"
+#include <unordered_map>
+
+std::vector<DBCScheduledMessage> scheduleDBCMessages(CyclicTransmitScheduler& scheduler, CANTransmitQueue& queue,
+                                                     const DBCDatabase& database, const SignalEncoder& encoder,
+                                                     std::string_view transmitter) {
+    std::vector<DBCScheduledMessage> scheduled;
+    std::unordered_map<std::uint32_t, std::uint32_t> messagesPerPeriod;
+    for (const DBCMessage& message : database.messages) {
+        const std::uint32_t periodMs = database.messageCycleTimeMs(message);
+        if (periodMs == 0 || message.transmitter != transmitter) {
+            continue;
+        }
+        FrameTemplate frame;
+        if (!encoder.makeTemplate(message.id, message.extended, frame)) {
+            continue;
+        }
+        for (std::size_t i = 0; i < message.signals.size(); ++i) {
+            const DBCSignal& signal = message.signals[i];
+            const double startValue = database.numericAttribute(signal.attributes, "GenSigStartValue", 0.0);
+            if (startValue != 0.0 && !signal.isMultiplexed) {
+                frame.setRaw(static_cast<int>(i), static_cast<std::uint64_t>(static_cast<std::int64_t>(startValue)));
+            }
+        }
+
+        const std::chrono::milliseconds period(periodMs);
+        const std::chrono::milliseconds phase(messagesPerPeriod[periodMs]++ % periodMs);
+        const CyclicMessageId id = frame.isFD()
+            ? scheduler.addMessageFD(queue, frame.toMessageFD(), period, TxPriority::Command, phase)
+            : scheduler.addMessage(queue, frame.toMessage(), period, TxPriority::Command, phase);
+        scheduled.push_back(DBCScheduledMessage{message.dbcId(), id});
+    }
+    return scheduled;
+}
@@ -0,0 +1,23 @@
+#ifndef DBC_SCHEDULE_HPP
+#define DBC_SCHEDULE_HPP
+
+#include "cyclic_transmit_scheduler.hpp"
+#include "dbc_database.hpp"
+#include "signal_encoder.hpp"
+#include <string_view>
+#include <vector>
+
+struct DBCScheduledMessage {
+    std::uint32_t dbcId;
+    CyclicMessageId cyclicId;  // For CyclicTransmitScheduler::updatePayload()
+};
+
+// Registers every cyclic message that transmitter sends (GenMsgCycleTime,
+// see DBCDatabase::messageCycleTimeMs) with the scheduler. The first payload
+// carries each signal's GenSigStartValue. Messages of equal period are
+// phase-shifted by 1 ms against each other to spread the bus load.
+std::vector<DBCScheduledMessage> scheduleDBCMessages(CyclicTransmitScheduler& scheduler, CANTransmitQueue& queue,
+                                                     const DBCDatabase& database, const SignalEncoder& encoder,
+                                                     std::string_view transmitter);
+
+#endif // DBC_SCHEDULE_HPP
@@ -0,0 +1,105 @@
+#include "mapped_file.hpp"
+#include <cerrno>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& path) {
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "Opening " << path << " failed! Error code: " << GetLastError() << std::endl;
+        return;
+    }
+    m_file = file;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        std::cerr << "Reading the size of " << path << " failed! Error code: " << GetLastError() << std::endl;
+        return;
+    }
+    m_size = static_cast<std::size_t>(fileSize.QuadPart);
+    if (m_size == 0) {
+        m_open = true;  // Empty files cannot be mapped
+        return;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        std::cerr << "Mapping " << path << " failed! Error code: " << GetLastError() << std::endl;
+        m_size = 0;
+        return;
+    }
+    m_mapping = mapping;
+
+    m_data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (m_data == nullptr) {
+        std::cerr << "Mapping " << path << " failed! Error code: " << GetLastError() << std::endl;
+        m_size = 0;
+        return;
+    }
+    m_open = true;
+}
+
+MappedFile::~MappedFile() {
+    if (m_data != nullptr) {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping != nullptr) {
+        CloseHandle(m_mapping);
+    }
+    if (m_file != nullptr) {
+        CloseHandle(m_file);
+    }
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "Opening " << path << " failed! Error code: " << errno << std::endl;
+        return;
+    }
+
+    struct stat status;
+    if (::fstat(fd, &status) != 0) {
+        std::cerr << "Reading the size of " << path << " failed! Error code: " << errno << std::endl;
+        ::close(fd);
+        return;
+    }
+    m_size = static_cast<std::size_t>(status.st_size);
+    if (m_size == 0) {
+        ::close(fd);
+        m_open = true;  // Empty files cannot be mapped
+        return;
+    }
+
+    void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // The mapping keeps its own reference to the file
+    if (data == MAP_FAILED) {
+        std::cerr << "Mapping " << path << " failed! Error code: " << errno << std::endl;
+        m_size = 0;
+        return;
+    }
+    ::madvise(data, m_size, MADV_SEQUENTIAL);
+    m_data = static_cast<const char*>(data);
+    m_open = true;
+}
+
+MappedFile::~MappedFile() {
+    if (m_data != nullptr) {
+        ::munmap(const_cast<char*>(m_data), m_size);
+    }
+}
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef MONOTONIC_CLOCK_HPP
+#define MONOTONIC_CLOCK_HPP
+
+#include <chrono>
+#include <cstdint>
+
+// Microseconds on the host's steady clock. All channels and benches in the
+// process share this time base, so samples stamped with it can be compared directly.
+inline std::uint64_t monotonicMicros() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+#endif // MONOTONIC_CLOCK_HPP
@@ -0,0 +1,102 @@
+#include "pcan_transport.hpp"
+#include <iostream>
+
+PCANTransport::PCANTransport(TPCANHandle handle) : m_handle(handle) {}
+
+PCANTransport::~PCANTransport() {
+    uninitialize();
+}
+
+TPCANStatus PCANTransport::initialize(TPCANBaudrate baudrate) {
+    TPCANStatus status = CAN_Initialize(m_handle, baudrate);
+    if (status == PCAN_ERROR_OK) {
+        m_initialized = true;
+        registerReceiveEvent();
+    }
+    return status;
+}
+
+TPCANStatus PCANTransport::initializeFD(const std::string& bitrateFD) {
+    // CAN_InitializeFD takes a non-const string, so hand it a private copy
+    std::vector<char> bitrate(bitrateFD.begin(), bitrateFD.end());
+    bitrate.push_back('\0');
+    TPCANStatus status = CAN_InitializeFD(m_handle, bitrate.data());
+    if (status == PCAN_ERROR_OK) {
+        m_initialized = true;
+        registerReceiveEvent();
+    }
+    return status;
+}
+
+void PCANTransport::uninitialize() {
+    if (m_receiveEvent != nullptr) {
+        HANDLE noEvent = nullptr;
+        CAN_SetValue(m_handle, PCAN_RECEIVE_EVENT, &noEvent, sizeof(noEvent));
+        CloseHandle(m_receiveEvent);
+        m_receiveEvent = nullptr;
+    }
+    if (m_initialized) {
+        CAN_Uninitialize(m_handle);
+        m_initialized = false;
+    }
+}
+
+void PCANTransport::registerReceiveEvent() {
+    // Let the driver signal an event whenever frames arrive instead of polling
+    m_receiveEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+    TPCANStatus status = CAN_SetValue(m_handle, PCAN_RECEIVE_EVENT, &m_receiveEvent, sizeof(m_receiveEvent));
+    if (status != PCAN_ERROR_OK) {
+        std::cerr << "CAN receive event registration failed! Error code: " << status << std::endl;
+        CloseHandle(m_receiveEvent);
+        m_receiveEvent = nullptr;
+    }
+}
+
+TPCANStatus PCANTransport::write(TPCANMsg& message) {
+    return CAN_Write(m_handle, &message);
+}
+
+TPCANStatus PCANTransport::writeFD(TPCANMsgFD& message) {
+    return CAN_WriteFD(m_handle, &message);
+}
+
+TPCANStatus PCANTransport::read(TPCANMsg& message, TPCANTimestamp* timestamp) {
+    return CAN_Read(m_handle, &message, timestamp);
+}
+
+TPCANStatus PCANTransport::readFD(TPCANMsgFD& message, TPCANTimestampFD* timestamp) {
+    return CAN_ReadFD(m_handle, &message, timestamp);
+}
+
+bool PCANTransport::waitForReceive(unsigned int timeoutMs) {
+    if (m_receiveEvent == nullptr) {
+        return false;
+    }
+    return WaitForSingleObject(m_receiveEvent, timeoutMs) == WAIT_OBJECT_0;
+}
+
+void PCANTransport::wakeReceiver() {
+    if (m_receiveEvent != nullptr) {
+        SetEvent(m_receiveEvent);
+    }
+}
+
+std::vector<TPCANChannelInformation> PCANTransport::attachedChannels() {
+    DWORD count = 0;
+    TPCANStatus status = CAN_GetValue(PCAN_NONEBUS, PCAN_ATTACHED_CHANNELS_COUNT, &count, sizeof(count));
+    if (status != PCAN_ERROR_OK) {
+        std::cerr << "PCAN channel discovery failed! Error code: " << status << std::endl;
+        return {};
+    }
+    std::vector<TPCANChannelInformation> channels(count);
+    if (count == 0) {
+        return channels;
+    }
+    status = CAN_GetValue(PCAN_NONEBUS, PCAN_ATTACHED_CHANNELS, channels.data(),
+                          static_cast<DWORD>(channels.size() * sizeof(TPCANChannelInformation)));
+    if (status != PCAN_ERROR_OK) {
+        std::cerr << "PCAN channel discovery failed! Error code: " << status << std::endl;
+        return {};
+    }
+    return channels;
+}
@@ -0,0 +1,41 @@
+#ifndef PCAN_TRANSPORT_HPP
+#define PCAN_TRANSPORT_HPP
+
+#include "can_transport.hpp"
+#include "PCANBasic.h"
+#include <windows.h>
+#include <vector>
+
+// CANTransport backed by a PEAK adapter through the PCAN-Basic API (Windows only)
+class PCANTransport : public CANTransport {
+public:
+    explicit PCANTransport(TPCANHandle handle);
+    ~PCANTransport() override;
+
+    TPCANStatus initialize(TPCANBaudrate baudrate) override;
+    TPCANStatus initializeFD(const std::string& bitrateFD) override;
+    void uninitialize() override;
+
+    TPCANStatus write(TPCANMsg& message) override;
+    TPCANStatus writeFD(TPCANMsgFD& message) override;
+    TPCANStatus read(TPCANMsg& message, TPCANTimestamp* timestamp) override;
+    TPCANStatus readFD(TPCANMsgFD& message, TPCANTimestampFD* timestamp) override;
+
+    bool waitForReceive(unsigned int timeoutMs) override;
+    void wakeReceiver() override;
+    bool hasReceiveNotification() const override { return m_receiveEvent != nullptr; }
+
+    TPCANHandle handle() const { return m_handle; }
+
+    // All PCAN channels currently attached to this PC (PCAN_ATTACHED_CHANNELS)
+    static std::vector<TPCANChannelInformation> attachedChannels();
+
+private:
+    void registerReceiveEvent();
+
+    TPCANHandle m_handle;
+    bool m_initialized = false;
+    HANDLE m_receiveEvent = nullptr; // Auto-reset event signalled by the driver when frames arrive
+};
+
+#endif // PCAN_TRANSPORT_HPP
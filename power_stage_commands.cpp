@@ -0,0 +1,63 @@
+#include "power_stage_commands.hpp"
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+PowerStageCommands::PowerStageCommands(const SignalEncoder& encoder, CANTransmitQueue& queue, const BenchConfig& config,
+                                       std::size_t bench, std::size_t cellCount)
+    : m_queue(queue), m_cells(cellCount) {
+    std::unordered_map<std::string, std::size_t> frameIndex;  // Message name -> m_frames
+    for (std::size_t cell = 0; cell < cellCount; ++cell) {
+        std::string modeMessage;
+        std::string modeSignal;
+        std::string valueMessage;
+        std::string valueSignal;
+        if (!expandSignalPattern(config.setpointModePattern, bench, cell, modeMessage, modeSignal)
+            || !expandSignalPattern(config.setpointValuePattern, bench, cell, valueMessage, valueSignal)) {
+            return;  // Not configured; the patterns are the same for every cell
+        }
+        if (modeMessage != valueMessage) {
+            std::cerr << "Power stage command of bench " << bench + 1 << ", cell " << cell + 1
+                      << " skipped! Mode and value are in different messages" << std::endl;
+            continue;
+        }
+
+        auto [it, added] = frameIndex.emplace(modeMessage, m_frames.size());
+        if (added) {
+            m_frames.emplace_back();
+            encoder.makeTemplate(modeMessage, m_frames.back());  // Stays invalid for an unknown message
+        }
+        const FrameTemplate& frame = m_frames[it->second];
+        if (!frame.isValid()) {
+            continue;
+        }
+        CellCommand command;
+        command.modeIndex = frame.signalIndex(modeSignal);
+        command.valueIndex = frame.signalIndex(valueSignal);
+        if (command.modeIndex < 0 || command.valueIndex < 0) {
+            continue;
+        }
+        command.frame = it->second;
+        m_cells[cell] = command;
+        ++m_commandedCells;
+    }
+}
+
+bool PowerStageCommands::send(std::size_t cell, const CellSetpoint& setpoint) {
+    if (cell >= m_cells.size() || m_cells[cell].frame == NoFrame) {
+        return false;
+    }
+    const CellCommand& command = m_cells[cell];
+    FrameTemplate& frame = m_frames[command.frame];
+    const bool off = setpoint.mode == SetpointMode::Off;
+    frame.setRaw(command.modeIndex, static_cast<std::uint64_t>(setpoint.mode));
+    frame.set(command.valueIndex, off ? 0.0 : setpoint.value);
+
+    const TxPriority priority = off ? TxPriority::Safety : TxPriority::Setpoint;
+    if (frame.isFD()) {
+        m_queue.sendFD(frame.toMessageFD(), priority);
+    } else {
+        m_queue.send(frame.toMessage(), priority);
+    }
+    return true;
+}
@@ -0,0 +1,51 @@
+#ifndef POWER_STAGE_COMMANDS_HPP
+#define POWER_STAGE_COMMANDS_HPP
+
+#include "TestOperations.hpp"
+#include "bench_config.hpp"
+#include "can_transmit_queue.hpp"
+#include "signal_encoder.hpp"
+#include <cstddef>
+#include <vector>
+
+// Puts the TestOperations setpoints of one bench on its CAN channel as the
+// power-stage command frames named by the setpoint patterns of bench.cfg.
+//
+// Cells whose patterns name the same message share one frame, so commanding
+// one cell resends the others' last setpoints instead of clearing them.
+// Setpoints go out as TxPriority::Setpoint and are coalesced while waiting;
+// output off goes out as TxPriority::Safety, overtaking and dropping the
+// setpoint still waiting for the same frame.
+//
+// Not thread-safe: meant for TestOperations::CommandSink, which runs with
+// the bench's lock held.
+class PowerStageCommands {
+public:
+    // queue and encoder must outlive the object
+    PowerStageCommands(const SignalEncoder& encoder, CANTransmitQueue& queue, const BenchConfig& config,
+                       std::size_t bench, std::size_t cellCount);
+
+    PowerStageCommands(const PowerStageCommands&) = delete;
+    PowerStageCommands& operator=(const PowerStageCommands&) = delete;
+
+    std::size_t commandedCells() const { return m_commandedCells; }
+
+    // Returns false if the cell has no command frame
+    bool send(std::size_t cell, const CellSetpoint& setpoint);
+
+private:
+    static constexpr std::size_t NoFrame = static_cast<std::size_t>(-1);
+
+    struct CellCommand {
+        std::size_t frame = NoFrame;  // Index into m_frames
+        int modeIndex = -1;
+        int valueIndex = -1;
+    };
+
+    CANTransmitQueue& m_queue;
+    std::vector<FrameTemplate> m_frames;
+    std::vector<CellCommand> m_cells;
+    std::size_t m_commandedCells = 0;
+};
+
+#endif // POWER_STAGE_COMMANDS_HPP
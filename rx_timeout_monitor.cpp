@@ -0,0 +1,51 @@
+#include "rx_timeout_monitor.hpp"
+
+RxTimeoutMonitor::RxTimeoutMonitor(const DBCDatabase& database, std::string_view localNode, double timeoutFactor) {
+    for (const DBCMessage& message : database.messages) {
+        const std::uint32_t periodMs = database.messageCycleTimeMs(message);
+        if (periodMs == 0 || message.transmitter == localNode) {
+            continue;
+        }
+        m_index.emplace(message.dbcId(), m_dbcIds.size());
+        m_dbcIds.push_back(message.dbcId());
+        m_timeouts.push_back(static_cast<std::uint64_t>(periodMs * timeoutFactor * 1000.0));
+    }
+    m_lastSeenUs.reset(new std::atomic<std::uint64_t>[m_dbcIds.size()]());
+}
+
+bool RxTimeoutMonitor::setTimeout(std::uint32_t dbcId, std::uint64_t timeoutUs) {
+    auto it = m_index.find(dbcId);
+    if (it == m_index.end()) {
+        return false;
+    }
+    m_timeouts[it->second] = timeoutUs;
+    return true;
+}
+
+void RxTimeoutMonitor::arm(std::uint64_t nowUs) {
+    for (std::size_t i = 0; i < m_dbcIds.size(); ++i) {
+        m_lastSeenUs[i].store(nowUs, std::memory_order_relaxed);
+    }
+}
+
+std::size_t RxTimeoutMonitor::checkTimeouts(std::uint64_t nowUs, std::vector<RxTimeout>& timedOut) const {
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < m_dbcIds.size(); ++i) {
+        const std::uint64_t lastSeen = m_lastSeenUs[i].load(std::memory_order_relaxed);
+        // A frame stamped after nowUs was read is not overdue
+        if (nowUs > lastSeen && nowUs - lastSeen > m_timeouts[i]) {
+            timedOut.push_back(RxTimeout{m_dbcIds[i], nowUs - lastSeen});
+            ++count;
+        }
+    }
+    return count;
+}
+
+bool RxTimeoutMonitor::isTimedOut(std::uint32_t dbcId, std::uint64_t nowUs) const {
+    auto it = m_index.find(dbcId);
+    if (it == m_index.end()) {
+        return false;
+    }
+    const std::uint64_t lastSeen = m_lastSeenUs[it->second].load(std::memory_order_relaxed);
+    return nowUs > lastSeen && nowUs - lastSeen > m_timeouts[it->second];
+}
@@ -0,0 +1,56 @@
+#ifndef RX_TIMEOUT_MONITOR_HPP
+#define RX_TIMEOUT_MONITOR_HPP
+
+#include "dbc_database.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+struct RxTimeout {
+    std::uint32_t dbcId;
+    std::uint64_t silentUs;  // Time since the last frame (or since arm())
+};
+
+// Receive timeout supervision for the cyclic messages of a DBC. Every
+// message with a GenMsgCycleTime that localNode does not send itself is
+// expected at least every timeoutFactor cycle times.
+//
+// frameReceived() is called by the acquisition thread; checkTimeouts() and
+// isTimedOut() may run concurrently on any thread (safety monitor, GUI).
+class RxTimeoutMonitor {
+public:
+    RxTimeoutMonitor(const DBCDatabase& database, std::string_view localNode, double timeoutFactor = 3.0);
+
+    RxTimeoutMonitor(const RxTimeoutMonitor&) = delete;
+    RxTimeoutMonitor& operator=(const RxTimeoutMonitor&) = delete;
+
+    std::size_t messageCount() const { return m_timeouts.size(); }
+
+    // Overrides the timeout of one supervised message; call before arm()
+    bool setTimeout(std::uint32_t dbcId, std::uint64_t timeoutUs);
+
+    // Starts supervision: messages never received count as silent from nowUs
+    void arm(std::uint64_t nowUs);
+
+    void frameReceived(std::uint32_t id, bool extended, std::uint64_t timeUs) {
+        auto it = m_index.find(extended ? (id | 0x80000000U) : id);
+        if (it != m_index.end()) {
+            m_lastSeenUs[it->second].store(timeUs, std::memory_order_relaxed);
+        }
+    }
+
+    // Appends every overdue message to timedOut; returns how many were added
+    std::size_t checkTimeouts(std::uint64_t nowUs, std::vector<RxTimeout>& timedOut) const;
+    bool isTimedOut(std::uint32_t dbcId, std::uint64_t nowUs) const;
+
+private:
+    std::unordered_map<std::uint32_t, std::size_t> m_index;  // dbcId -> slot
+    std::vector<std::uint32_t> m_dbcIds;
+    std::vector<std::uint64_t> m_timeouts;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> m_lastSeenUs;
+};
+
+#endif // RX_TIMEOUT_MONITOR_HPP
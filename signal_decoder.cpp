@@ -0,0 +1,299 @@
+#include "signal_decoder.hpp"
+#include "can_transport.hpp"
+#include "dbc_bit_codec.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+std::uint32_t hashExtendedId(std::uint32_t dbcId) {
+    std::uint32_t hash = dbcId * 0x9E3779B1U;
+    return hash ^ (hash >> 16);
+}
+
+} // namespace
+
+SignalDecoder::SignalDecoder(const DBCDatabase& database)
+    : m_standardIndex(2048, NoMessage) {
+    std::size_t extendedCount = 0;
+    std::size_t signalCount = 0;
+    for (const DBCMessage& message : database.messages) {
+        extendedCount += message.extended ? 1 : 0;
+        signalCount += message.signals.size();
+    }
+    std::size_t tableSize = 2;
+    while (tableSize < extendedCount * 2) {
+        tableSize <<= 1;
+    }
+    m_extendedKeys.assign(tableSize, 0);  // 0 is free: extended DBC IDs always have bit 31 set
+    m_extendedValues.assign(tableSize, NoMessage);
+    m_extendedMask = static_cast<std::uint32_t>(tableSize - 1);
+    m_plans.reserve(signalCount);
+    m_signalNames.reserve(signalCount);
+
+    for (const DBCMessage& message : database.messages) {
+        if (!message.extended && message.id >= m_standardIndex.size()) {
+            continue;  // Not a valid 11-bit identifier
+        }
+
+        const std::uint32_t firstPlan = static_cast<std::uint32_t>(m_plans.size());
+        for (const DBCSignal& signal : message.signals) {
+            const bool intel = signal.byteOrder == DBCByteOrder::Intel;
+            const DBCBitWindow window = intel ? dbcIntelWindow(signal.startBit, signal.bitLength)
+                                              : dbcMotorolaWindow(signal.startBit, signal.bitLength);
+            SignalPlan plan{};
+            plan.mask = dbcBitMask(signal.bitLength);
+            plan.factor = signal.factor;
+            plan.offset = signal.offset;
+            plan.byteOffset = window.byteOffset;
+            plan.shift = window.shift;
+            plan.requiredBytes = window.requiredBytes;
+            plan.bigEndian = !intel;
+            plan.wide = !window.fits;
+            plan.startBit = signal.startBit;
+            plan.bitLength = signal.bitLength;
+            plan.switchIndex = -1;
+            plan.signalId = static_cast<std::uint32_t>(m_signalNames.size());
+
+            if (signal.valueType == DBCValueType::Float32 && signal.bitLength == 32) {
+                plan.kind = ValueKind::Float32;
+            } else if (signal.valueType == DBCValueType::Float64 && signal.bitLength == 64) {
+                plan.kind = ValueKind::Float64;
+            } else if (!signal.isSigned && signal.bitLength == 64) {
+                plan.kind = ValueKind::Unsigned64;
+            } else {
+                plan.kind = ValueKind::Integer;
+                plan.signShift = static_cast<std::uint8_t>(signal.isSigned ? 64 - signal.bitLength : 0);
+            }
+
+            m_plans.push_back(plan);
+
+            std::string name = message.name + '.' + signal.name;
+            m_signalIds.emplace(name, plan.signalId);
+            m_signalNames.push_back(std::move(name));
+        }
+        m_maxSignalsPerMessage = std::max(m_maxSignalsPerMessage, message.signals.size());
+
+        MessagePlan messagePlan{{0, 0}, message.dbcId()};
+        compileMultiplexing(message, firstPlan, messagePlan);
+
+        const std::int32_t index = static_cast<std::int32_t>(m_messages.size());
+        m_messages.push_back(messagePlan);
+        if (!message.extended) {
+            m_standardIndex[message.id] = index;
+        } else {
+            std::uint32_t slot = hashExtendedId(messagePlan.dbcId) & m_extendedMask;
+            while (m_extendedKeys[slot] != 0) {
+                slot = (slot + 1) & m_extendedMask;
+            }
+            m_extendedKeys[slot] = messagePlan.dbcId;
+            m_extendedValues[slot] = index;
+        }
+    }
+}
+
+void SignalDecoder::compileMultiplexing(const DBCMessage& message, std::uint32_t firstPlan, MessagePlan& messagePlan) {
+    const std::size_t signalCount = message.signals.size();
+    std::vector<int> selector(signalCount);
+    for (std::size_t i = 0; i < signalCount; ++i) {
+        selector[i] = message.multiplexorIndex(message.signals[i]);
+    }
+
+    // Signals whose multiplexor chain does not end at an always-present
+    // signal (unknown multiplexor or a cycle) can never be selected
+    std::vector<bool> reachable(signalCount, false);
+    for (std::size_t i = 0; i < signalCount; ++i) {
+        int current = static_cast<int>(i);
+        for (std::size_t depth = 0; depth <= signalCount && current >= 0; ++depth) {
+            if (selector[current] == DBCMessage::AlwaysPresent) {
+                reachable[i] = true;
+                break;
+            }
+            current = selector[current];
+        }
+    }
+
+    std::vector<std::uint32_t> alwaysPresent;
+    std::vector<std::vector<std::size_t>> dependents(signalCount);
+    for (std::size_t i = 0; i < signalCount; ++i) {
+        if (!reachable[i]) {
+            continue;
+        }
+        if (selector[i] == DBCMessage::AlwaysPresent) {
+            alwaysPresent.push_back(firstPlan + static_cast<std::uint32_t>(i));
+        } else {
+            dependents[selector[i]].push_back(i);
+        }
+    }
+    messagePlan.alwaysPresent = addGroup(alwaysPresent);
+
+    for (std::size_t mux = 0; mux < signalCount; ++mux) {
+        if (dependents[mux].empty()) {
+            continue;
+        }
+        // Simple multiplexing is the single range [multiplexValue, multiplexValue]
+        std::vector<std::vector<DBCMultiplexRange>> ranges;
+        std::uint64_t tableSize = 0;
+        for (std::size_t dependent : dependents[mux]) {
+            const DBCSignal& signal = message.signals[dependent];
+            ranges.push_back(signal.multiplexRanges.empty()
+                                 ? std::vector<DBCMultiplexRange>{{signal.multiplexValue, signal.multiplexValue}}
+                                 : signal.multiplexRanges);
+            for (const DBCMultiplexRange& range : ranges.back()) {
+                tableSize = std::max<std::uint64_t>(tableSize, std::uint64_t(range.high) + 1);
+            }
+        }
+        const std::uint16_t muxBits = message.signals[mux].bitLength;
+        if (muxBits < 32) {
+            tableSize = std::min<std::uint64_t>(tableSize, std::uint64_t(1) << muxBits);
+        }
+        tableSize = std::min<std::uint64_t>(tableSize, MaxSwitchTableSize);
+
+        // Neighbouring values usually select the same signals (ranges), so
+        // consecutive identical groups share their m_groupPlans run
+        SignalPlan& muxPlan = m_plans[firstPlan + mux];
+        muxPlan.switchIndex = static_cast<std::int32_t>(m_switches.size());
+        m_switches.push_back(MuxSwitch{static_cast<std::uint32_t>(m_switchTable.size()),
+                                       static_cast<std::uint32_t>(tableSize)});
+        std::vector<std::uint32_t> group;
+        std::vector<std::uint32_t> previous;
+        PlanGroup previousGroup{0, 0};
+        for (std::uint32_t value = 0; value < tableSize; ++value) {
+            group.clear();
+            for (std::size_t d = 0; d < dependents[mux].size(); ++d) {
+                for (const DBCMultiplexRange& range : ranges[d]) {
+                    if (value >= range.low && value <= range.high) {
+                        group.push_back(firstPlan + static_cast<std::uint32_t>(dependents[mux][d]));
+                        break;
+                    }
+                }
+            }
+            if (value == 0 || group != previous) {
+                previousGroup = addGroup(group);
+                previous = group;
+            }
+            m_switchTable.push_back(previousGroup);
+        }
+    }
+}
+
+SignalDecoder::PlanGroup SignalDecoder::addGroup(const std::vector<std::uint32_t>& plans) {
+    const PlanGroup group{static_cast<std::uint32_t>(m_groupPlans.size()), static_cast<std::uint32_t>(plans.size())};
+    m_groupPlans.insert(m_groupPlans.end(), plans.begin(), plans.end());
+    return group;
+}
+
+std::int32_t SignalDecoder::findMessagePlan(std::uint32_t id, bool extended) const {
+    if (!extended) {
+        return id < m_standardIndex.size() ? m_standardIndex[id] : NoMessage;
+    }
+    const std::uint32_t key = id | 0x80000000U;
+    for (std::uint32_t slot = hashExtendedId(key) & m_extendedMask;; slot = (slot + 1) & m_extendedMask) {
+        if (m_extendedKeys[slot] == key) {
+            return m_extendedValues[slot];
+        }
+        if (m_extendedKeys[slot] == 0) {
+            return NoMessage;
+        }
+    }
+}
+
+std::uint64_t SignalDecoder::extractRaw(const SignalPlan& plan, const std::uint8_t* data) {
+    if (plan.wide) {
+        return dbcExtractBitsSlow(data, plan.startBit, plan.bitLength, !plan.bigEndian);
+    }
+    const std::uint64_t window = plan.bigEndian ? dbcLoadBigEndian64(data + plan.byteOffset)
+                                                : dbcLoadLittleEndian64(data + plan.byteOffset);
+    return (window >> plan.shift) & plan.mask;
+}
+
+double SignalDecoder::toPhysical(const SignalPlan& plan, std::uint64_t raw) {
+    switch (plan.kind) {
+    case ValueKind::Integer:
+        // signShift is 0 for unsigned values, which are below 2^63 here
+        return static_cast<double>(static_cast<std::int64_t>(raw << plan.signShift) >> plan.signShift)
+               * plan.factor + plan.offset;
+    case ValueKind::Unsigned64:
+        return static_cast<double>(raw) * plan.factor + plan.offset;
+    case ValueKind::Float32: {
+        const std::uint32_t bits = static_cast<std::uint32_t>(raw);
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return static_cast<double>(value) * plan.factor + plan.offset;
+    }
+    case ValueKind::Float64: {
+        double value;
+        std::memcpy(&value, &raw, sizeof(value));
+        return value * plan.factor + plan.offset;
+    }
+    }
+    return 0.0;
+}
+
+std::size_t SignalDecoder::decode(const TPCANMsg& message, DecodedSignal* values) const {
+    if (message.MSGTYPE & PCAN_MESSAGE_RTR) {
+        return 0;
+    }
+    return decode(message.ID, (message.MSGTYPE & PCAN_MESSAGE_EXTENDED) != 0, message.DATA,
+                  std::min<std::size_t>(message.LEN, sizeof(message.DATA)), values);
+}
+
+std::size_t SignalDecoder::decode(const TPCANMsgFD& message, DecodedSignal* values) const {
+    if (message.MSGTYPE & PCAN_MESSAGE_RTR) {
+        return 0;
+    }
+    return decode(message.ID, (message.MSGTYPE & PCAN_MESSAGE_EXTENDED) != 0, message.DATA,
+                  canFdDlcToLength(message.DLC), values);
+}
+
+std::size_t SignalDecoder::decode(std::uint32_t id, bool extended, const std::uint8_t* data, std::size_t length,
+                                  DecodedSignal* values) const {
+    const std::int32_t index = findMessagePlan(id, extended);
+    if (index == NoMessage) {
+        return 0;
+    }
+    const MessagePlan& message = m_messages[index];
+
+    // Every window may read up to 7 bytes past the payload; those bits are
+    // masked off but must be initialized
+    length = std::min<std::size_t>(length, 64);
+    std::uint8_t payload[PaddedPayloadSize];
+    std::memcpy(payload, data, length);
+    std::memset(payload + length, 0, 8);
+
+    return decodeGroup(message.alwaysPresent, payload, length, values);
+}
+
+std::size_t SignalDecoder::decodeGroup(PlanGroup group, const std::uint8_t* payload, std::size_t length,
+                                       DecodedSignal* values) const {
+    const std::uint32_t* planIndices = m_groupPlans.data() + group.first;
+    std::size_t count = 0;
+    for (std::uint32_t i = 0; i < group.count; ++i) {
+        const SignalPlan& plan = m_plans[planIndices[i]];
+        if (plan.requiredBytes > length) {
+            continue;  // Frame too short
+        }
+        const std::uint64_t raw = extractRaw(plan, payload);
+        values[count].signalId = plan.signalId;
+        values[count].value = toPhysical(plan, raw);
+        ++count;
+
+        // A multiplexor pulls in the signals its value selects; nesting is
+        // as deep as the extended multiplexing tree
+        if (plan.switchIndex >= 0) {
+            const MuxSwitch& mux = m_switches[plan.switchIndex];
+            if (raw < mux.tableSize) {
+                count += decodeGroup(m_switchTable[mux.tableOffset + raw], payload, length, values + count);
+            }
+        }
+    }
+    return count;
+}
+
+std::uint32_t SignalDecoder::findSignalId(std::string_view messageName, std::string_view signalName) const {
+    std::string key;
+    key.reserve(messageName.size() + 1 + signalName.size());
+    key.append(messageName).append(1, '.').append(signalName);
+    auto it = m_signalIds.find(key);
+    return it != m_signalIds.end() ? it->second : UINT32_MAX;
+}
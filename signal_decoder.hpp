@@ -0,0 +1,126 @@
+#ifndef SIGNAL_DECODER_HPP
+#define SIGNAL_DECODER_HPP
+
+#include "PCANBasic.h"
+#include "dbc_database.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// A decoded physical value. signalId numbers every signal of the database
+// consecutively in message order (see SignalDecoder::findSignalId).
+struct DecodedSignal {
+    std::uint32_t signalId;
+    double value;
+};
+
+// Decodes CAN frames using extraction plans compiled once from a DBC
+// database. A plan is a flat array of {window offset, shift, mask, scale,
+// offset} records per message, and messages are found through a direct
+// 2048-entry table for standard IDs and an open-addressing hash for
+// extended IDs, so decoding a frame never walks the DBC model.
+//
+// Multiplexed signals (simple "m<n>" and extended SG_MUL_VAL_) are grouped
+// by the multiplexor value that selects them: every multiplexor owns a jump
+// table indexed by its raw value, so a frame only touches the signals it
+// actually carries, however many groups the message defines.
+//
+// The decoder is immutable after construction and may be shared between
+// threads.
+class SignalDecoder {
+public:
+    explicit SignalDecoder(const DBCDatabase& database);
+
+    // Decode every signal present in the frame into values, which must hold
+    // at least maxSignalsPerMessage() entries. Multiplexed signals are only
+    // emitted when the frame's multiplexor selects them. Returns the number
+    // of values written; 0 for unknown IDs and RTR frames.
+    std::size_t decode(const TPCANMsg& message, DecodedSignal* values) const;
+    std::size_t decode(const TPCANMsgFD& message, DecodedSignal* values) const;
+    std::size_t decode(std::uint32_t id, bool extended, const std::uint8_t* data, std::size_t length,
+                       DecodedSignal* values) const;
+
+    std::size_t signalCount() const { return m_signalNames.size(); }
+    std::size_t maxSignalsPerMessage() const { return m_maxSignalsPerMessage; }
+
+    // Returns UINT32_MAX if the signal does not exist
+    std::uint32_t findSignalId(std::string_view messageName, std::string_view signalName) const;
+    const std::string& signalName(std::uint32_t signalId) const { return m_signalNames[signalId]; }  // "Message.Signal"
+
+private:
+    enum class ValueKind : std::uint8_t {
+        Integer,    // Signed or unsigned below 64 bits, sign handled by signShift
+        Unsigned64,
+        Float32,
+        Float64
+    };
+
+    struct SignalPlan {
+        std::uint64_t mask;
+        double factor;
+        double offset;
+        std::uint16_t byteOffset;
+        std::uint8_t shift;
+        std::uint8_t signShift;       // 64 - bitLength for signed integers, 0 otherwise
+        std::uint16_t requiredBytes;
+        ValueKind kind;
+        bool bigEndian;
+        bool wide;                    // Needs the bit-by-bit fallback
+        std::uint16_t startBit;       // Only used by the fallback
+        std::uint16_t bitLength;
+        std::int32_t switchIndex;     // m_switches entry if this is a multiplexor, -1 otherwise
+        std::uint32_t signalId;
+    };
+
+    // A run of m_groupPlans: the signals decoded together
+    struct PlanGroup {
+        std::uint32_t first;
+        std::uint32_t count;
+    };
+
+    // Jump table of a multiplexor, m_switchTable[tableOffset + raw value]
+    struct MuxSwitch {
+        std::uint32_t tableOffset;
+        std::uint32_t tableSize;      // Values at or above select nothing
+    };
+
+    struct MessagePlan {
+        PlanGroup alwaysPresent;      // Signals not selected by any multiplexor
+        std::uint32_t dbcId;
+    };
+
+    // Largest jump table per multiplexor; selector ranges beyond it are ignored
+    static constexpr std::uint32_t MaxSwitchTableSize = 65536;
+
+    static constexpr std::size_t PaddedPayloadSize = 64 + 8;
+    static constexpr std::int32_t NoMessage = -1;
+
+    static std::uint64_t extractRaw(const SignalPlan& plan, const std::uint8_t* data);
+    static double toPhysical(const SignalPlan& plan, std::uint64_t raw);
+    std::int32_t findMessagePlan(std::uint32_t id, bool extended) const;
+    void compileMultiplexing(const DBCMessage& message, std::uint32_t firstPlan, MessagePlan& messagePlan);
+    PlanGroup addGroup(const std::vector<std::uint32_t>& plans);
+    std::size_t decodeGroup(PlanGroup group, const std::uint8_t* payload, std::size_t length,
+                            DecodedSignal* values) const;
+
+    std::vector<SignalPlan> m_plans;
+    std::vector<MessagePlan> m_messages;
+    std::vector<std::uint32_t> m_groupPlans;   // m_plans indices
+    std::vector<MuxSwitch> m_switches;
+    std::vector<PlanGroup> m_switchTable;
+    std::vector<std::int32_t> m_standardIndex;  // 11-bit ID -> m_messages index
+
+    // Extended IDs: linear probing, load factor <= 0.5
+    std::vector<std::uint32_t> m_extendedKeys;
+    std::vector<std::int32_t> m_extendedValues;
+    std::uint32_t m_extendedMask = 0;
+
+    std::size_t m_maxSignalsPerMessage = 0;
+    std::vector<std::string> m_signalNames;
+    std::unordered_map<std::string, std::uint32_t> m_signalIds;
+};
+
+#endif // SIGNAL_DECODER_HPP
@@ -0,0 +1,166 @@
+#include "signal_encoder.hpp"
+#include "can_transport.hpp"
+#include "dbc_bit_codec.hpp"
+#include <algorithm>
+#include <cstring>
+
+SignalEncoder::SignalEncoder(const DBCDatabase& database) {
+    m_messages.reserve(database.messages.size());
+    for (const DBCMessage& message : database.messages) {
+        MessagePlan messagePlan{message.id, message.extended, message.size > 8,
+                                static_cast<std::uint16_t>(std::min<std::size_t>(message.size, 64)),
+                                static_cast<std::uint32_t>(m_plans.size()),
+                                static_cast<std::uint32_t>(message.signals.size()), message.name, {}};
+        for (const DBCSignal& signal : message.signals) {
+            const bool intel = signal.byteOrder == DBCByteOrder::Intel;
+            const DBCBitWindow window = intel ? dbcIntelWindow(signal.startBit, signal.bitLength)
+                                              : dbcMotorolaWindow(signal.startBit, signal.bitLength);
+            SignalPlan plan{};
+            plan.mask = dbcBitMask(signal.bitLength);
+            plan.factor = signal.factor;
+            plan.offset = signal.offset;
+            plan.byteOffset = window.byteOffset;
+            plan.shift = window.shift;
+            plan.bigEndian = !intel;
+            plan.wide = !window.fits;
+            plan.isSigned = signal.isSigned;
+            plan.startBit = signal.startBit;
+            plan.bitLength = signal.bitLength;
+            const int multiplexor = message.multiplexorIndex(signal);
+            plan.multiplexorPlan = multiplexor >= 0 ? static_cast<std::int32_t>(messagePlan.firstPlan) + multiplexor : -1;
+            plan.multiplexValue = signal.multiplexRanges.empty() ? signal.multiplexValue : signal.multiplexRanges.front().low;
+            if (signal.valueType == DBCValueType::Float32 && signal.bitLength == 32) {
+                plan.kind = ValueKind::Float32;
+            } else if (signal.valueType == DBCValueType::Float64 && signal.bitLength == 64) {
+                plan.kind = ValueKind::Float64;
+            } else {
+                plan.kind = ValueKind::Integer;
+            }
+
+            m_plans.push_back(plan);
+            messagePlan.signalNames.push_back(signal.name);
+        }
+        m_messages.push_back(std::move(messagePlan));
+    }
+}
+
+bool SignalEncoder::makeTemplate(std::string_view messageName, FrameTemplate& frame) const {
+    for (const MessagePlan& message : m_messages) {
+        if (message.name == messageName) {
+            return makeTemplate(message, frame);
+        }
+    }
+    return false;
+}
+
+bool SignalEncoder::makeTemplate(std::uint32_t id, bool extended, FrameTemplate& frame) const {
+    for (const MessagePlan& message : m_messages) {
+        if (message.id == id && message.extended == extended) {
+            return makeTemplate(message, frame);
+        }
+    }
+    return false;
+}
+
+bool SignalEncoder::makeTemplate(const MessagePlan& message, FrameTemplate& frame) const {
+    frame.m_encoder = this;
+    frame.m_message = &message;
+    frame.clear();
+    return true;
+}
+
+int FrameTemplate::signalIndex(std::string_view signalName) const {
+    const std::vector<std::string>& names = m_message->signalNames;
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        if (names[i] == signalName) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void FrameTemplate::set(int signalIndex, double value) {
+    const SignalEncoder::SignalPlan& plan = m_encoder->m_plans[m_message->firstPlan + signalIndex];
+    std::uint64_t raw = 0;
+    switch (plan.kind) {
+    case SignalEncoder::ValueKind::Integer:
+        raw = dbcPhysicalToRaw(value, plan.factor, plan.offset, plan.bitLength, plan.isSigned);
+        break;
+    case SignalEncoder::ValueKind::Float32: {
+        const float scaled = static_cast<float>((value - plan.offset) / plan.factor);
+        std::uint32_t bits;
+        std::memcpy(&bits, &scaled, sizeof(bits));
+        raw = bits;
+        break;
+    }
+    case SignalEncoder::ValueKind::Float64: {
+        const double scaled = (value - plan.offset) / plan.factor;
+        std::memcpy(&raw, &scaled, sizeof(raw));
+        break;
+    }
+    }
+    setRaw(signalIndex, raw);
+}
+
+bool FrameTemplate::set(std::string_view signalName, double value) {
+    const int index = signalIndex(signalName);
+    if (index < 0) {
+        return false;
+    }
+    set(index, value);
+    return true;
+}
+
+void FrameTemplate::setRaw(int signalIndex, std::uint64_t raw) {
+    const SignalEncoder::SignalPlan& plan = m_encoder->m_plans[m_message->firstPlan + signalIndex];
+    write(plan, raw);
+    // A multiplexed signal is only meaningful with its multiplexor values,
+    // up through every level of extended multiplexing (bounded in case the
+    // DBC describes a cycle)
+    const SignalEncoder::SignalPlan* current = &plan;
+    for (std::uint32_t depth = 0; depth < m_message->planCount && current->multiplexorPlan >= 0; ++depth) {
+        const SignalEncoder::SignalPlan& multiplexor = m_encoder->m_plans[current->multiplexorPlan];
+        write(multiplexor, current->multiplexValue);
+        current = &multiplexor;
+    }
+}
+
+void FrameTemplate::clear() {
+    std::memset(m_data, 0, sizeof(m_data));
+}
+
+void FrameTemplate::write(const SignalEncoder::SignalPlan& plan, std::uint64_t raw) {
+    raw &= plan.mask;
+    if (plan.wide) {
+        dbcInsertBitsSlow(m_data, plan.startBit, plan.bitLength, !plan.bigEndian, raw);
+        return;
+    }
+    std::uint8_t* window = m_data + plan.byteOffset;
+    const std::uint64_t fieldMask = plan.mask << plan.shift;
+    if (plan.bigEndian) {
+        const std::uint64_t bits = dbcLoadBigEndian64(window);
+        dbcStoreBigEndian64(window, (bits & ~fieldMask) | (raw << plan.shift));
+    } else {
+        const std::uint64_t bits = dbcLoadLittleEndian64(window);
+        dbcStoreLittleEndian64(window, (bits & ~fieldMask) | (raw << plan.shift));
+    }
+}
+
+TPCANMsg FrameTemplate::toMessage() const {
+    TPCANMsg message{};
+    message.ID = m_message->id;
+    message.MSGTYPE = m_message->extended ? PCAN_MESSAGE_EXTENDED : PCAN_MESSAGE_STANDARD;
+    message.LEN = static_cast<BYTE>(std::min<std::size_t>(m_message->size, 8));
+    std::memcpy(message.DATA, m_data, sizeof(message.DATA));
+    return message;
+}
+
+TPCANMsgFD FrameTemplate::toMessageFD() const {
+    TPCANMsgFD message{};
+    message.ID = m_message->id;
+    message.MSGTYPE = static_cast<TPCANMessageType>((m_message->extended ? PCAN_MESSAGE_EXTENDED : PCAN_MESSAGE_STANDARD)
+                                                    | (m_message->fd ? PCAN_MESSAGE_FD : 0));
+    message.DLC = canFdLengthToDlc(m_message->size);
+    std::memcpy(message.DATA, m_data, sizeof(message.DATA));
+    return message;
+}
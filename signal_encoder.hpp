@@ -0,0 +1,105 @@
+#ifndef SIGNAL_ENCODER_HPP
+#define SIGNAL_ENCODER_HPP
+
+#include "PCANBasic.h"
+#include "dbc_database.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class FrameTemplate;
+
+// Packs physical values into CAN payloads using plans compiled once from a
+// DBC database (scaling, byte order, signedness, float signals and
+// multiplexors). Frames are built through FrameTemplate objects, which
+// reference the encoder; it must outlive them.
+class SignalEncoder {
+public:
+    explicit SignalEncoder(const DBCDatabase& database);
+
+    // Initializes frame for the given message with an all-zero payload.
+    // Returns false if the message is unknown.
+    bool makeTemplate(std::string_view messageName, FrameTemplate& frame) const;
+    bool makeTemplate(std::uint32_t id, bool extended, FrameTemplate& frame) const;
+
+private:
+    friend class FrameTemplate;
+
+    enum class ValueKind : std::uint8_t {
+        Integer,
+        Float32,
+        Float64
+    };
+
+    struct SignalPlan {
+        std::uint64_t mask;
+        double factor;
+        double offset;
+        std::uint16_t byteOffset;
+        std::uint8_t shift;
+        ValueKind kind;
+        bool bigEndian;
+        bool wide;                    // Needs the bit-by-bit fallback
+        bool isSigned;
+        std::uint16_t startBit;
+        std::uint16_t bitLength;
+        std::int32_t multiplexorPlan; // Index into m_plans of the selecting multiplexor, -1 if none
+        std::uint32_t multiplexValue; // Multiplexor value written along with this signal
+    };
+
+    struct MessagePlan {
+        std::uint32_t id;
+        bool extended;
+        bool fd;                      // Payload longer than 8 bytes
+        std::uint16_t size;
+        std::uint32_t firstPlan;
+        std::uint32_t planCount;
+        std::string name;
+        std::vector<std::string> signalNames;
+    };
+
+    bool makeTemplate(const MessagePlan& message, FrameTemplate& frame) const;
+
+    std::vector<SignalPlan> m_plans;
+    std::vector<MessagePlan> m_messages;
+};
+
+// A preallocated frame for one message. set() rewrites only the bits of the
+// given signal (and its chain of multiplexors, for multiplexed signals), so periodic
+// setpoint updates neither allocate nor re-encode the rest of the payload.
+//
+// Typical use: resolve signal indices once, then per update
+//     frame.set(currentIndex, amps);
+//     queue.send(frame.toMessage());
+class FrameTemplate {
+public:
+    bool isValid() const { return m_encoder != nullptr; }
+
+    // Index for set()/setRaw(), or -1 if the message has no such signal
+    int signalIndex(std::string_view signalName) const;
+
+    void set(int signalIndex, double value);
+    bool set(std::string_view signalName, double value);
+    void setRaw(int signalIndex, std::uint64_t raw);
+    void clear();  // Back to an all-zero payload
+
+    std::uint32_t id() const { return m_message->id; }
+    bool isFD() const { return m_message->fd; }
+
+    // Classic frame (first 8 payload bytes) or FD frame with the full payload
+    TPCANMsg toMessage() const;
+    TPCANMsgFD toMessageFD() const;
+
+private:
+    friend class SignalEncoder;
+
+    void write(const SignalEncoder::SignalPlan& plan, std::uint64_t raw);
+
+    const SignalEncoder* m_encoder = nullptr;
+    const SignalEncoder::MessagePlan* m_message = nullptr;
+    std::uint8_t m_data[64 + 8] = {};  // Payload plus room for the last 8-byte window
+};
+
+#endif // SIGNAL_ENCODER_HPP
@@ -0,0 +1,38 @@
+#include "signal_filter.hpp"
+
+namespace {
+
+constexpr SignalFilterConfig PassThrough{-1.0, 0, 0};
+
+}
+
+SignalChangeFilter::SignalChangeFilter(std::size_t signalCount)
+    : m_states(signalCount, SignalState{PassThrough, 0.0, 0, false}) {}
+
+void SignalChangeFilter::configure(std::uint32_t signalId, const SignalFilterConfig& config) {
+    if (signalId < m_states.size()) {
+        m_states[signalId].config = config;
+    }
+}
+
+void SignalChangeFilter::configureAll(const SignalFilterConfig& config) {
+    for (SignalState& state : m_states) {
+        state.config = config;
+    }
+}
+
+void SignalChangeFilter::reset() {
+    for (SignalState& state : m_states) {
+        state.hasValue = false;
+    }
+}
+
+std::size_t SignalChangeFilter::filter(DecodedSignal* values, std::size_t count, std::uint64_t timeUs) {
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (accept(values[i].signalId, values[i].value, timeUs)) {
+            values[kept++] = values[i];
+        }
+    }
+    return kept;
+}
@@ -0,0 +1,72 @@
+#ifndef SIGNAL_FILTER_HPP
+#define SIGNAL_FILTER_HPP
+
+#include "signal_decoder.hpp"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Per-signal suppression rules. A sample is forwarded when it differs from
+// the last forwarded value by more than deadband and at least minIntervalUs
+// have passed since then; maxIntervalUs (0 = off) forces a refresh of an
+// unchanged value so downstream timestamps do not go stale.
+struct SignalFilterConfig {
+    double deadband = 0.0;           // Physical units; 0 forwards any change, < 0 forwards everything
+    std::uint64_t minIntervalUs = 0;
+    std::uint64_t maxIntervalUs = 0;
+};
+
+// Change-detection stage between the decoder and the UI/loggers.
+// Compares every sample with the last value it let through, so a slow drift
+// still gets forwarded once it accumulates past the deadband.
+//
+// Not thread-safe: each acquisition thread owns its own filter.
+class SignalChangeFilter {
+public:
+    // Every signal starts as pass-through until configured
+    explicit SignalChangeFilter(std::size_t signalCount);
+
+    void configure(std::uint32_t signalId, const SignalFilterConfig& config);
+    void configureAll(const SignalFilterConfig& config);
+
+    // Forgets the last forwarded values, so the next sample of every signal passes
+    void reset();
+
+    bool accept(std::uint32_t signalId, double value, std::uint64_t timeUs) {
+        SignalState& state = m_states[signalId];
+        const std::uint64_t elapsed = timeUs - state.lastTimeUs;
+        const bool refresh = state.config.maxIntervalUs != 0 && elapsed >= state.config.maxIntervalUs;
+        if (state.hasValue && !refresh
+            && (elapsed < state.config.minIntervalUs || std::fabs(value - state.lastValue) <= state.config.deadband)) {
+            ++m_suppressed;
+            return false;
+        }
+        state.lastValue = value;
+        state.lastTimeUs = timeUs;
+        state.hasValue = true;
+        ++m_forwarded;
+        return true;
+    }
+
+    // Drops suppressed entries from values in place, keeping the order of
+    // the rest. Returns the number of entries left.
+    std::size_t filter(DecodedSignal* values, std::size_t count, std::uint64_t timeUs);
+
+    std::uint64_t forwardedCount() const { return m_forwarded; }
+    std::uint64_t suppressedCount() const { return m_suppressed; }
+
+private:
+    struct SignalState {
+        SignalFilterConfig config;
+        double lastValue;
+        std::uint64_t lastTimeUs;
+        bool hasValue;
+    };
+
+    std::vector<SignalState> m_states;  // Indexed by decoder signal ID
+    std::uint64_t m_forwarded = 0;
+    std::uint64_t m_suppressed = 0;
+};
+
+#endif // SIGNAL_FILTER_HPP
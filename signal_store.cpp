@@ -0,0 +1,44 @@
+#include "signal_store.hpp"
+
+SignalStore::SignalStore(std::size_t benchCount, std::size_t cellCount, std::size_t signalCount)
+    : m_benchCount(benchCount),
+      m_cellCount(cellCount),
+      m_signalCount(signalCount),
+      m_linesPerRow((signalCount + WordsPerLine - 1) / WordsPerLine),
+      // Value-initialization zeroes the atomics: sequence 0, time 0 = never written
+      m_sequences(new SequenceLine[benchCount * cellCount]()),
+      m_values(new WordLine[benchCount * cellCount * m_linesPerRow]()),
+      m_times(new WordLine[benchCount * cellCount * m_linesPerRow]()) {}
+
+void SignalStore::writeCell(std::size_t bench, std::size_t cell, const std::size_t* signals, const double* values,
+                            std::size_t count, std::uint64_t timeUs) {
+    const std::size_t row = rowIndex(bench, cell);
+    std::atomic<std::uint32_t>& sequence = m_sequences[row].value;
+    const std::uint32_t start = sequence.load(std::memory_order_relaxed);
+    sequence.store(start + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t i = 0; i < count; ++i) {
+        valueWord(row, signals[i]).store(toBits(values[i]), std::memory_order_relaxed);
+        timeWord(row, signals[i]).store(timeUs, std::memory_order_relaxed);
+    }
+    sequence.store(start + 2, std::memory_order_release);
+}
+
+void SignalStore::readCell(std::size_t bench, std::size_t cell, SignalValue* values) const {
+    const std::size_t row = rowIndex(bench, cell);
+    const std::atomic<std::uint32_t>& sequence = m_sequences[row].value;
+    for (;;) {
+        const std::uint32_t before = sequence.load(std::memory_order_acquire);
+        if (before & 1U) {
+            continue;
+        }
+        for (std::size_t signal = 0; signal < m_signalCount; ++signal) {
+            values[signal].value = fromBits(valueWord(row, signal).load(std::memory_order_relaxed));
+            values[signal].timeUs = timeWord(row, signal).load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) == before) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,125 @@
+#ifndef SIGNAL_STORE_HPP
+#define SIGNAL_STORE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+// Per-cell signal slots of the store
+enum class CellSignal : std::uint32_t {
+    Voltage = 0,
+    Temperature = 1,
+    Current = 2,
+    Count
+};
+
+struct SignalValue {
+    double value = 0.0;
+    std::uint64_t timeUs = 0;   // monotonicMicros() of the sample; 0 = never written
+};
+
+// Latest value and timestamp for every (bench, cell, signal).
+//
+// Each cell has its own seqlock. Values and timestamps are kept in separate
+// arrays (SoA), every cell's row starting on its own cache line, so a
+// reader pulls in only the lines of the cell it asks for and readers of
+// different cells never share a line with each other's writer.
+//
+// Writers: exactly one thread may write a given cell at a time (the
+// acquisition thread of its bench). Readers never block the writer and
+// never write shared memory; they retry only if they overlapped an update.
+class SignalStore {
+public:
+    SignalStore(std::size_t benchCount, std::size_t cellCount, std::size_t signalCount = static_cast<std::size_t>(CellSignal::Count));
+
+    SignalStore(const SignalStore&) = delete;
+    SignalStore& operator=(const SignalStore&) = delete;
+
+    std::size_t benchCount() const { return m_benchCount; }
+    std::size_t cellCount() const { return m_cellCount; }
+    std::size_t signalCount() const { return m_signalCount; }
+
+    void write(std::size_t bench, std::size_t cell, std::size_t signal, double value, std::uint64_t timeUs) {
+        const std::size_t row = rowIndex(bench, cell);
+        std::atomic<std::uint32_t>& sequence = m_sequences[row].value;
+        const std::uint32_t start = sequence.load(std::memory_order_relaxed);
+        sequence.store(start + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        valueWord(row, signal).store(toBits(value), std::memory_order_relaxed);
+        timeWord(row, signal).store(timeUs, std::memory_order_relaxed);
+        sequence.store(start + 2, std::memory_order_release);
+    }
+
+    // Updates several signals of one cell as a single atomic snapshot
+    void writeCell(std::size_t bench, std::size_t cell, const std::size_t* signals, const double* values,
+                   std::size_t count, std::uint64_t timeUs);
+
+    SignalValue read(std::size_t bench, std::size_t cell, std::size_t signal) const {
+        const std::size_t row = rowIndex(bench, cell);
+        const std::atomic<std::uint32_t>& sequence = m_sequences[row].value;
+        SignalValue result;
+        for (;;) {
+            const std::uint32_t before = sequence.load(std::memory_order_acquire);
+            if (before & 1U) {
+                continue;  // Update in progress
+            }
+            const std::uint64_t bits = valueWord(row, signal).load(std::memory_order_relaxed);
+            result.timeUs = timeWord(row, signal).load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == before) {
+                result.value = fromBits(bits);
+                return result;
+            }
+        }
+    }
+
+    SignalValue read(std::size_t bench, std::size_t cell, CellSignal signal) const {
+        return read(bench, cell, static_cast<std::size_t>(signal));
+    }
+
+    // Consistent snapshot of all signals of one cell; values needs signalCount() entries
+    void readCell(std::size_t bench, std::size_t cell, SignalValue* values) const;
+
+private:
+    static constexpr std::size_t CacheLineSize = 64;
+    static constexpr std::size_t WordsPerLine = CacheLineSize / sizeof(std::uint64_t);
+
+    struct alignas(CacheLineSize) SequenceLine {
+        std::atomic<std::uint32_t> value;
+    };
+    struct alignas(CacheLineSize) WordLine {
+        std::atomic<std::uint64_t> words[WordsPerLine];
+    };
+
+    std::size_t rowIndex(std::size_t bench, std::size_t cell) const { return bench * m_cellCount + cell; }
+
+    std::atomic<std::uint64_t>& valueWord(std::size_t row, std::size_t signal) const {
+        return m_values[row * m_linesPerRow + signal / WordsPerLine].words[signal % WordsPerLine];
+    }
+    std::atomic<std::uint64_t>& timeWord(std::size_t row, std::size_t signal) const {
+        return m_times[row * m_linesPerRow + signal / WordsPerLine].words[signal % WordsPerLine];
+    }
+
+    static std::uint64_t toBits(double value) {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+    static double fromBits(std::uint64_t bits) {
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    std::size_t m_benchCount;
+    std::size_t m_cellCount;
+    std::size_t m_signalCount;
+    std::size_t m_linesPerRow;
+    std::unique_ptr<SequenceLine[]> m_sequences;  // One seqlock per cell
+    std::unique_ptr<WordLine[]> m_values;         // Value bits, m_linesPerRow lines per cell
+    std::unique_ptr<WordLine[]> m_times;          // Timestamps, same layout as m_values
+};
+
+#endif // SIGNAL_STORE_HPP
@@ -0,0 +1,350 @@
+#include "socketcan_transport.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include <linux/errqueue.h>
+#include <linux/net_tstamp.h>
+#include <net/if.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr std::size_t ControlBufferSize = CMSG_SPACE(sizeof(scm_timestamping)) + 64;
+
+TPCANStatus statusFromErrno(int error) {
+    switch (error) {
+    case EAGAIN:
+#if EAGAIN != EWOULDBLOCK
+    case EWOULDBLOCK:
+#endif
+        return PCAN_ERROR_QRCVEMPTY;
+    case ENOBUFS:
+        return PCAN_ERROR_QXMTFULL;
+    case ENETDOWN:
+        return PCAN_ERROR_BUSOFF;
+    case ENODEV:
+    case ENXIO:
+        return PCAN_ERROR_ILLHW;
+    case EINVAL:
+        return PCAN_ERROR_ILLPARAMVAL;
+    case EAFNOSUPPORT:
+    case EPROTONOSUPPORT:
+        return PCAN_ERROR_NODRIVER;  // can/can-raw kernel modules not loaded
+    default:
+        return PCAN_ERROR_UNKNOWN;
+    }
+}
+
+canid_t toSocketCANId(DWORD id, TPCANMessageType type) {
+    if (type & PCAN_MESSAGE_EXTENDED) {
+        return (id & CAN_EFF_MASK) | CAN_EFF_FLAG;
+    }
+    return id & CAN_SFF_MASK;
+}
+
+void fromSocketCANId(canid_t canId, DWORD& id, TPCANMessageType& type) {
+    type = PCAN_MESSAGE_STANDARD;
+    if (canId & CAN_EFF_FLAG) {
+        type |= PCAN_MESSAGE_EXTENDED;
+        id = canId & CAN_EFF_MASK;
+    } else {
+        id = canId & CAN_SFF_MASK;
+    }
+    if (canId & CAN_RTR_FLAG) {
+        type |= PCAN_MESSAGE_RTR;
+    }
+}
+
+TPCANTimestamp toPCANTimestamp(std::uint64_t us) {
+    TPCANTimestamp timestamp;
+    const std::uint64_t millis = us / 1000;
+    timestamp.millis = static_cast<DWORD>(millis & 0xFFFFFFFFULL);
+    timestamp.millis_overflow = static_cast<WORD>(millis >> 32);
+    timestamp.micros = static_cast<WORD>(us % 1000);
+    return timestamp;
+}
+
+} // namespace
+
+SocketCANTransport::SocketCANTransport(std::string interfaceName)
+    : m_interfaceName(std::move(interfaceName)) {}
+
+SocketCANTransport::~SocketCANTransport() {
+    uninitialize();
+}
+
+TPCANStatus SocketCANTransport::initialize(TPCANBaudrate) {
+    return open(false);
+}
+
+TPCANStatus SocketCANTransport::initializeFD(const std::string&) {
+    return open(true);
+}
+
+TPCANStatus SocketCANTransport::open(bool fd) {
+    if (m_socket >= 0) {
+        return PCAN_ERROR_ILLOPERATION;
+    }
+    m_fd = fd;
+
+    m_socket = ::socket(PF_CAN, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, CAN_RAW);
+    if (m_socket < 0) {
+        return statusFromErrno(errno);
+    }
+
+    ifreq request;
+    std::memset(&request, 0, sizeof(request));
+    std::strncpy(request.ifr_name, m_interfaceName.c_str(), IFNAMSIZ - 1);
+    if (::ioctl(m_socket, SIOCGIFINDEX, &request) < 0) {
+        const int error = errno;
+        uninitialize();
+        return error == ENODEV ? PCAN_ERROR_ILLHW : statusFromErrno(error);
+    }
+
+    if (fd) {
+        const int enable = 1;
+        if (::setsockopt(m_socket, SOL_CAN_RAW, CAN_RAW_FD_FRAMES, &enable, sizeof(enable)) < 0) {
+            uninitialize();
+            return PCAN_ERROR_ILLOPERATION;  // Kernel or interface without CAN FD support
+        }
+    }
+
+    // Prefer hardware timestamps, but always ask for software ones as a fallback
+    const int timestampFlags = SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE |
+                               SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+    if (::setsockopt(m_socket, SOL_SOCKET, SO_TIMESTAMPING, &timestampFlags, sizeof(timestampFlags)) < 0) {
+        std::cerr << "SocketCAN: SO_TIMESTAMPING not available on " << m_interfaceName << std::endl;
+    }
+
+    sockaddr_can address;
+    std::memset(&address, 0, sizeof(address));
+    address.can_family = AF_CAN;
+    address.can_ifindex = request.ifr_ifindex;
+    if (::bind(m_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        const int error = errno;
+        uninitialize();
+        return statusFromErrno(error);
+    }
+
+    m_wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    // One canfd_frame-sized slot per batch entry works for both modes
+    m_headers.assign(ReceiveBatchSize, mmsghdr());
+    m_iovecs.assign(ReceiveBatchSize, iovec());
+    m_frameBuffers.assign(ReceiveBatchSize * sizeof(canfd_frame), 0);
+    m_controlBuffers.assign(ReceiveBatchSize * ControlBufferSize, 0);
+    for (std::size_t i = 0; i < ReceiveBatchSize; ++i) {
+        m_iovecs[i].iov_base = &m_frameBuffers[i * sizeof(canfd_frame)];
+        m_iovecs[i].iov_len = fd ? CANFD_MTU : CAN_MTU;
+        m_headers[i].msg_hdr.msg_iov = &m_iovecs[i];
+        m_headers[i].msg_hdr.msg_iovlen = 1;
+    }
+    return PCAN_ERROR_OK;
+}
+
+void SocketCANTransport::uninitialize() {
+    if (m_wakeFd >= 0) {
+        ::close(m_wakeFd);
+        m_wakeFd = -1;
+    }
+    if (m_socket >= 0) {
+        ::close(m_socket);
+        m_socket = -1;
+    }
+}
+
+TPCANStatus SocketCANTransport::sendRaw(const void* frame, std::size_t size) {
+    if (m_socket < 0) {
+        return PCAN_ERROR_INITIALIZE;
+    }
+    const ssize_t written = ::write(m_socket, frame, size);
+    if (written < 0) {
+        // A full socket queue shows up as EAGAIN on a non-blocking socket
+        return errno == EAGAIN ? PCAN_ERROR_QXMTFULL : statusFromErrno(errno);
+    }
+    return static_cast<std::size_t>(written) == size ? PCAN_ERROR_OK : PCAN_ERROR_UNKNOWN;
+}
+
+TPCANStatus SocketCANTransport::write(TPCANMsg& message) {
+    can_frame frame;
+    std::memset(&frame, 0, sizeof(frame));
+    frame.can_id = toSocketCANId(message.ID, message.MSGTYPE);
+    if (message.MSGTYPE & PCAN_MESSAGE_RTR) {
+        frame.can_id |= CAN_RTR_FLAG;
+    }
+    frame.can_dlc = std::min<BYTE>(message.LEN, CAN_MAX_DLEN);
+    std::memcpy(frame.data, message.DATA, frame.can_dlc);
+    return sendRaw(&frame, CAN_MTU);
+}
+
+TPCANStatus SocketCANTransport::writeFD(TPCANMsgFD& message) {
+    if (!m_fd) {
+        return PCAN_ERROR_ILLOPERATION;
+    }
+    if ((message.MSGTYPE & PCAN_MESSAGE_FD) == 0) {
+        // Classic frame on an FD socket
+        TPCANMsg classic;
+        classic.ID = message.ID;
+        classic.MSGTYPE = message.MSGTYPE;
+        classic.LEN = std::min<BYTE>(message.DLC, 8);
+        std::memcpy(classic.DATA, message.DATA, sizeof(classic.DATA));
+        return write(classic);
+    }
+    canfd_frame frame;
+    std::memset(&frame, 0, sizeof(frame));
+    frame.can_id = toSocketCANId(message.ID, message.MSGTYPE);
+    frame.len = static_cast<__u8>(canFdDlcToLength(message.DLC));
+    if (message.MSGTYPE & PCAN_MESSAGE_BRS) {
+        frame.flags |= CANFD_BRS;
+    }
+    if (message.MSGTYPE & PCAN_MESSAGE_ESI) {
+        frame.flags |= CANFD_ESI;
+    }
+    std::memcpy(frame.data, message.DATA, frame.len);
+    return sendRaw(&frame, CANFD_MTU);
+}
+
+std::size_t SocketCANTransport::receive(std::size_t maxCount, TPCANStatus& status) {
+    if (m_socket < 0) {
+        status = PCAN_ERROR_INITIALIZE;
+        return 0;
+    }
+    const std::size_t wanted = std::min(maxCount, ReceiveBatchSize);
+    for (std::size_t i = 0; i < wanted; ++i) {
+        m_headers[i].msg_hdr.msg_control = &m_controlBuffers[i * ControlBufferSize];
+        m_headers[i].msg_hdr.msg_controllen = ControlBufferSize;
+        m_headers[i].msg_hdr.msg_flags = 0;
+    }
+    const int received = ::recvmmsg(m_socket, m_headers.data(), static_cast<unsigned int>(wanted), MSG_DONTWAIT, nullptr);
+    if (received < 0) {
+        status = statusFromErrno(errno);
+        return 0;
+    }
+    status = static_cast<std::size_t>(received) == wanted ? PCAN_ERROR_OK : PCAN_ERROR_QRCVEMPTY;
+    return static_cast<std::size_t>(received);
+}
+
+std::uint64_t SocketCANTransport::frameTimestampUs(std::size_t index) const {
+    msghdr& header = const_cast<msghdr&>(m_headers[index].msg_hdr);
+    for (cmsghdr* message = CMSG_FIRSTHDR(&header); message != nullptr; message = CMSG_NXTHDR(&header, message)) {
+        if (message->cmsg_level == SOL_SOCKET && message->cmsg_type == SO_TIMESTAMPING) {
+            scm_timestamping timestamps;
+            std::memcpy(&timestamps, CMSG_DATA(message), sizeof(timestamps));
+            // ts[2] is the raw hardware timestamp, ts[0] the kernel software one
+            const timespec& chosen = (timestamps.ts[2].tv_sec != 0 || timestamps.ts[2].tv_nsec != 0)
+                                         ? timestamps.ts[2] : timestamps.ts[0];
+            return static_cast<std::uint64_t>(chosen.tv_sec) * 1000000ULL +
+                   static_cast<std::uint64_t>(chosen.tv_nsec) / 1000ULL;
+        }
+    }
+    return 0;
+}
+
+std::size_t SocketCANTransport::readBatch(TPCANMsg* messages, TPCANTimestamp* timestamps,
+                                          std::size_t maxCount, TPCANStatus& status) {
+    if (m_fd) {
+        status = PCAN_ERROR_ILLOPERATION;
+        return 0;
+    }
+    std::size_t total = 0;
+    while (total < maxCount) {
+        const std::size_t count = receive(maxCount - total, status);
+        for (std::size_t i = 0; i < count; ++i) {
+            const can_frame& frame = *reinterpret_cast<const can_frame*>(&m_frameBuffers[i * sizeof(canfd_frame)]);
+            TPCANMsg& message = messages[total + i];
+            fromSocketCANId(frame.can_id, message.ID, message.MSGTYPE);
+            message.LEN = std::min<BYTE>(frame.can_dlc, CAN_MAX_DLEN);
+            std::memset(message.DATA, 0, sizeof(message.DATA));
+            std::memcpy(message.DATA, frame.data, message.LEN);
+            if (timestamps != nullptr) {
+                timestamps[total + i] = toPCANTimestamp(frameTimestampUs(i));
+            }
+        }
+        total += count;
+        if (status != PCAN_ERROR_OK) {
+            break;
+        }
+    }
+    return total;
+}
+
+std::size_t SocketCANTransport::readBatchFD(TPCANMsgFD* messages, TPCANTimestampFD* timestamps,
+                                            std::size_t maxCount, TPCANStatus& status) {
+    if (!m_fd) {
+        status = PCAN_ERROR_ILLOPERATION;
+        return 0;
+    }
+    std::size_t total = 0;
+    while (total < maxCount) {
+        const std::size_t count = receive(maxCount - total, status);
+        for (std::size_t i = 0; i < count; ++i) {
+            const canfd_frame& frame = *reinterpret_cast<const canfd_frame*>(&m_frameBuffers[i * sizeof(canfd_frame)]);
+            TPCANMsgFD& message = messages[total + i];
+            fromSocketCANId(frame.can_id, message.ID, message.MSGTYPE);
+            std::memset(message.DATA, 0, sizeof(message.DATA));
+            if (static_cast<std::size_t>(m_headers[i].msg_len) == CANFD_MTU) {
+                message.MSGTYPE |= PCAN_MESSAGE_FD;
+                if (frame.flags & CANFD_BRS) message.MSGTYPE |= PCAN_MESSAGE_BRS;
+                if (frame.flags & CANFD_ESI) message.MSGTYPE |= PCAN_MESSAGE_ESI;
+                message.DLC = canFdLengthToDlc(frame.len);
+            } else {
+                message.DLC = std::min<BYTE>(frame.len, CAN_MAX_DLEN);
+            }
+            std::memcpy(message.DATA, frame.data, std::min<std::size_t>(frame.len, CANFD_MAX_DLEN));
+            if (timestamps != nullptr) {
+                timestamps[total + i] = frameTimestampUs(i);
+            }
+        }
+        total += count;
+        if (status != PCAN_ERROR_OK) {
+            break;
+        }
+    }
+    return total;
+}
+
+TPCANStatus SocketCANTransport::read(TPCANMsg& message, TPCANTimestamp* timestamp) {
+    TPCANStatus status;
+    return readBatch(&message, timestamp, 1, status) == 1 ? PCAN_ERROR_OK : status;
+}
+
+TPCANStatus SocketCANTransport::readFD(TPCANMsgFD& message, TPCANTimestampFD* timestamp) {
+    TPCANStatus status;
+    return readBatchFD(&message, timestamp, 1, status) == 1 ? PCAN_ERROR_OK : status;
+}
+
+bool SocketCANTransport::waitForReceive(unsigned int timeoutMs) {
+    if (m_socket < 0) {
+        return false;
+    }
+    pollfd fds[2];
+    fds[0].fd = m_socket;
+    fds[0].events = POLLIN;
+    fds[0].revents = 0;
+    fds[1].fd = m_wakeFd;
+    fds[1].events = POLLIN;
+    fds[1].revents = 0;
+    const int ready = ::poll(fds, m_wakeFd >= 0 ? 2 : 1, static_cast<int>(timeoutMs));
+    if (ready <= 0) {
+        return false;
+    }
+    if (m_wakeFd >= 0 && (fds[1].revents & POLLIN)) {
+        eventfd_t value;
+        ::eventfd_read(m_wakeFd, &value);
+    }
+    return true;
+}
+
+void SocketCANTransport::wakeReceiver() {
+    if (m_wakeFd >= 0) {
+        ::eventfd_write(m_wakeFd, 1);
+    }
+}
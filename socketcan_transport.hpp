@@ -0,0 +1,68 @@
+#ifndef SOCKETCAN_TRANSPORT_HPP
+#define SOCKETCAN_TRANSPORT_HPP
+
+#include "can_transport.hpp"
+#include "PCANBasic.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct mmsghdr;
+struct iovec;
+
+// CANTransport for Linux SocketCAN interfaces (can0, vcan0, ...), so bench
+// PCs can run without Windows and the PCAN-Basic driver.
+//
+// Reads use recvmmsg to fetch up to ReceiveBatchSize frames per syscall,
+// and each frame carries a kernel receive timestamp (SO_TIMESTAMPING).
+// Hardware timestamps are used when the controller provides them, with a
+// fallback to kernel software timestamps (e.g. on vcan).
+//
+// The bit rate belongs to the network interface and is configured outside
+// the process, e.g. "ip link set can0 type can bitrate 500000"; the values
+// passed to initialize/initializeFD are ignored.
+class SocketCANTransport : public CANTransport {
+public:
+    static constexpr std::size_t ReceiveBatchSize = 64;
+
+    explicit SocketCANTransport(std::string interfaceName);
+    ~SocketCANTransport() override;
+
+    TPCANStatus initialize(TPCANBaudrate baudrate) override;
+    TPCANStatus initializeFD(const std::string& bitrateFD) override;
+    void uninitialize() override;
+
+    TPCANStatus write(TPCANMsg& message) override;
+    TPCANStatus writeFD(TPCANMsgFD& message) override;
+    TPCANStatus read(TPCANMsg& message, TPCANTimestamp* timestamp) override;
+    TPCANStatus readFD(TPCANMsgFD& message, TPCANTimestampFD* timestamp) override;
+    std::size_t readBatch(TPCANMsg* messages, TPCANTimestamp* timestamps,
+                          std::size_t maxCount, TPCANStatus& status) override;
+    std::size_t readBatchFD(TPCANMsgFD* messages, TPCANTimestampFD* timestamps,
+                            std::size_t maxCount, TPCANStatus& status) override;
+
+    bool waitForReceive(unsigned int timeoutMs) override;
+    void wakeReceiver() override;
+    bool hasReceiveNotification() const override { return m_socket >= 0; }
+
+    const std::string& interfaceName() const { return m_interfaceName; }
+
+private:
+    TPCANStatus open(bool fd);
+    std::size_t receive(std::size_t maxCount, TPCANStatus& status);
+    std::uint64_t frameTimestampUs(std::size_t index) const;
+    TPCANStatus sendRaw(const void* frame, std::size_t size);
+
+    std::string m_interfaceName;
+    int m_socket = -1;
+    int m_wakeFd = -1;   // eventfd used by wakeReceiver to interrupt poll()
+    bool m_fd = false;
+
+    // recvmmsg buffers, allocated once in open()
+    std::vector<mmsghdr> m_headers;
+    std::vector<iovec> m_iovecs;
+    std::vector<unsigned char> m_frameBuffers;
+    std::vector<unsigned char> m_controlBuffers;
+};
+
+#endif // SOCKETCAN_TRANSPORT_HPP
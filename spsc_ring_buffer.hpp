@@ -0,0 +1,100 @@
+#ifndef SPSC_RING_BUFFER_HPP
+#define SPSC_RING_BUFFER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Fixed-capacity lock-free single-producer/single-consumer queue.
+// Exactly one thread may push and exactly one (other) thread may pop.
+// The capacity is rounded up to the next power of two so that indices
+// can be wrapped with a mask instead of a modulo.
+template <typename T>
+class SpscRingBuffer {
+public:
+    explicit SpscRingBuffer(std::size_t capacity)
+        : m_mask(roundUpToPowerOfTwo(capacity) - 1), m_slots(m_mask + 1) {}
+
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    // Producer side. Returns false (and drops the item) when the queue is full.
+    bool push(const T& item) {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_cachedTail > m_mask) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head - m_cachedTail > m_mask) {
+                return false;
+            }
+        }
+        m_slots[head & m_mask] = item;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false when the queue is empty.
+    bool pop(T& item) {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_cachedHead) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail == m_cachedHead) {
+                return false;
+            }
+        }
+        item = m_slots[tail & m_mask];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Pops up to maxCount items with a single index update.
+    std::size_t popBatch(T* items, std::size_t maxCount) {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        std::size_t available = m_cachedHead - tail;
+        if (available < maxCount) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            available = m_cachedHead - tail;
+        }
+        const std::size_t count = available < maxCount ? available : maxCount;
+        for (std::size_t i = 0; i < count; ++i) {
+            items[i] = m_slots[(tail + i) & m_mask];
+        }
+        if (count > 0) {
+            m_tail.store(tail + count, std::memory_order_release);
+        }
+        return count;
+    }
+
+    // Approximate when called concurrently with push/pop.
+    bool empty() const {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+    }
+
+    std::size_t size() const {
+        return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+    }
+
+    std::size_t capacity() const { return m_mask + 1; }
+
+private:
+    static std::size_t roundUpToPowerOfTwo(std::size_t value) {
+        std::size_t result = 2;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    static constexpr std::size_t CacheLineSize = 64;
+
+    const std::size_t m_mask;
+    std::vector<T> m_slots;
+
+    // Producer and consumer indices live on separate cache lines; each side
+    // keeps a private copy of the other's index to avoid re-reading it.
+    alignas(CacheLineSize) std::atomic<std::size_t> m_head{0};
+    std::size_t m_cachedTail = 0;
+    alignas(CacheLineSize) std::atomic<std::size_t> m_tail{0};
+    std::size_t m_cachedHead = 0;
+};
+
+#endif // SPSC_RING_BUFFER_HPP
@@ -0,0 +1,8 @@
+#ifndef THREAD_AFFINITY_HPP
+#define THREAD_AFFINITY_HPP
+
+// Restricts the calling thread to one logical CPU. Returns false if the
+// platform refused (or does not support) the request.
+bool pinCurrentThreadToCpu(unsigned int cpu);
+
+#endif // THREAD_AFFINITY_HPP
@@ -0,0 +1,302 @@
+#include "virtual_can_bus.hpp"
+#include "monotonic_clock.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+
+namespace {
+
+TPCANMsgFD toFD(const TPCANMsg& message) {
+    TPCANMsgFD messageFD;
+    messageFD.ID = message.ID;
+    messageFD.MSGTYPE = message.MSGTYPE;
+    messageFD.DLC = message.LEN;
+    std::memset(messageFD.DATA, 0, sizeof(messageFD.DATA));
+    std::memcpy(messageFD.DATA, message.DATA, sizeof(message.DATA));
+    return messageFD;
+}
+
+TPCANTimestamp toTimestamp(std::uint64_t us) {
+    TPCANTimestamp timestamp;
+    const std::uint64_t millis = us / 1000;
+    timestamp.millis = static_cast<DWORD>(millis & 0xFFFFFFFFULL);
+    timestamp.millis_overflow = static_cast<WORD>(millis >> 32);
+    timestamp.micros = static_cast<WORD>(us % 1000);
+    return timestamp;
+}
+
+} // namespace
+
+// One endpoint on a VirtualCANBus
+class VirtualCANNode : public CANTransport {
+public:
+    explicit VirtualCANNode(std::shared_ptr<VirtualCANBus> bus) : m_bus(std::move(bus)) {}
+    ~VirtualCANNode() override { uninitialize(); }
+
+    TPCANStatus initialize(TPCANBaudrate) override {
+        return attach(false);
+    }
+
+    TPCANStatus initializeFD(const std::string&) override {
+        return attach(true);
+    }
+
+    void uninitialize() override {
+        if (m_attached) {
+            m_bus->detach(this);
+            m_attached = false;
+        }
+    }
+
+    TPCANStatus write(TPCANMsg& message) override {
+        if (!m_attached) {
+            return PCAN_ERROR_INITIALIZE;
+        }
+        return m_bus->transmit(this, toFD(message));
+    }
+
+    TPCANStatus writeFD(TPCANMsgFD& message) override {
+        if (!m_attached) {
+            return PCAN_ERROR_INITIALIZE;
+        }
+        if (!m_fd) {
+            return PCAN_ERROR_ILLOPERATION;
+        }
+        return m_bus->transmit(this, message);
+    }
+
+    TPCANStatus read(TPCANMsg& message, TPCANTimestamp* timestamp) override {
+        Pending pending;
+        TPCANStatus status = pop(pending);
+        if (status != PCAN_ERROR_OK) {
+            return status;
+        }
+        message.ID = pending.message.ID;
+        message.MSGTYPE = pending.message.MSGTYPE;
+        message.LEN = pending.message.DLC;
+        std::memcpy(message.DATA, pending.message.DATA, sizeof(message.DATA));
+        if (timestamp != nullptr) {
+            *timestamp = toTimestamp(pending.deliveryUs);
+        }
+        return PCAN_ERROR_OK;
+    }
+
+    TPCANStatus readFD(TPCANMsgFD& message, TPCANTimestampFD* timestamp) override {
+        Pending pending;
+        TPCANStatus status = pop(pending);
+        if (status != PCAN_ERROR_OK) {
+            return status;
+        }
+        message = pending.message;
+        if (timestamp != nullptr) {
+            *timestamp = pending.deliveryUs;
+        }
+        return PCAN_ERROR_OK;
+    }
+
+    bool waitForReceive(unsigned int timeoutMs) override {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_wakeRequested) {
+            auto wakeAt = deadline;
+            if (!m_queue.empty()) {
+                const std::uint64_t nextDeliveryUs = m_queue.front().deliveryUs;
+                const std::uint64_t nowUs = m_bus->now();
+                if (nextDeliveryUs <= nowUs) {
+                    return true;
+                }
+                // On the host clock, sleep until the next frame is due; on a
+                // manual clock, advanceTime() notifies us instead.
+                if (!m_bus->m_manualClock.load(std::memory_order_relaxed)) {
+                    wakeAt = std::min(wakeAt, std::chrono::steady_clock::now() +
+                                              std::chrono::microseconds(nextDeliveryUs - nowUs));
+                }
+            }
+            if (m_arrival.wait_until(lock, wakeAt) == std::cv_status::timeout &&
+                std::chrono::steady_clock::now() >= deadline) {
+                return !m_queue.empty() && m_queue.front().deliveryUs <= m_bus->now();
+            }
+        }
+        m_wakeRequested = false;
+        return true;
+    }
+
+    void wakeReceiver() override {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_wakeRequested = true;
+        }
+        m_arrival.notify_all();
+    }
+
+    bool hasReceiveNotification() const override { return true; }
+
+private:
+    friend class VirtualCANBus;
+
+    struct Pending {
+        std::uint64_t deliveryUs;
+        TPCANMsgFD message;
+    };
+
+    TPCANStatus attach(bool fd) {
+        if (m_attached) {
+            return PCAN_ERROR_ILLOPERATION;
+        }
+        m_fd = fd;
+        m_bus->attach(this);
+        m_attached = true;
+        return PCAN_ERROR_OK;
+    }
+
+    TPCANStatus pop(Pending& pending) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_overrun) {
+            m_overrun = false;
+            return PCAN_ERROR_QOVERRUN;
+        }
+        if (m_queue.empty() || m_queue.front().deliveryUs > m_bus->now()) {
+            return PCAN_ERROR_QRCVEMPTY;
+        }
+        pending = m_queue.front();
+        m_queue.pop_front();
+        return PCAN_ERROR_OK;
+    }
+
+    // Called by the bus with the bus mutex held
+    void enqueue(const TPCANMsgFD& message, std::uint64_t deliveryUs, std::size_t capacity) {
+        // A classic controller cannot receive FD frames
+        if (!m_fd && (message.MSGTYPE & PCAN_MESSAGE_FD) != 0) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_queue.size() >= capacity) {
+                m_overrun = true;
+                return;
+            }
+            // Frames leave the bus serially, so never deliver before the previous one
+            if (!m_queue.empty()) {
+                deliveryUs = std::max(deliveryUs, m_queue.back().deliveryUs);
+            }
+            m_queue.push_back(Pending{ deliveryUs, message });
+        }
+        m_arrival.notify_all();
+    }
+
+    void notifyTimeAdvanced() {
+        { std::lock_guard<std::mutex> lock(m_mutex); }
+        m_arrival.notify_all();
+    }
+
+    std::shared_ptr<VirtualCANBus> m_bus;
+    bool m_attached = false;
+    bool m_fd = false;
+
+    std::mutex m_mutex;
+    std::condition_variable m_arrival;
+    std::deque<Pending> m_queue;
+    bool m_overrun = false;
+    bool m_wakeRequested = false;
+};
+
+VirtualCANBus::VirtualCANBus(VirtualBusConfig config)
+    : m_config(config), m_startUs(monotonicMicros()), m_random(config.seed) {}
+
+std::unique_ptr<CANTransport> VirtualCANBus::createNode() {
+    return std::make_unique<VirtualCANNode>(shared_from_this());
+}
+
+void VirtualCANBus::setManualClock(bool manual) {
+    if (manual) {
+        m_manualTimeUs.store(now(), std::memory_order_relaxed);
+    } else {
+        m_startUs.store(monotonicMicros() - m_manualTimeUs.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    m_manualClock.store(manual, std::memory_order_release);
+}
+
+void VirtualCANBus::advanceTime(std::uint64_t deltaUs) {
+    m_manualTimeUs.fetch_add(deltaUs, std::memory_order_acq_rel);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (VirtualCANNode* node : m_nodes) {
+        node->notifyTimeAdvanced();
+    }
+}
+
+std::uint64_t VirtualCANBus::now() const {
+    if (m_manualClock.load(std::memory_order_acquire)) {
+        return m_manualTimeUs.load(std::memory_order_acquire);
+    }
+    return monotonicMicros() - m_startUs.load(std::memory_order_relaxed);
+}
+
+void VirtualCANBus::startRecording() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_recorded.clear();
+    m_recording = true;
+}
+
+std::vector<RecordedFrame> VirtualCANBus::stopRecording() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_recording = false;
+    return std::move(m_recorded);
+}
+
+void VirtualCANBus::replay(const std::vector<RecordedFrame>& frames, double speedFactor) {
+    if (frames.empty() || speedFactor <= 0.0) {
+        return;
+    }
+    const std::uint64_t baseUs = now();
+    const std::uint64_t firstUs = frames.front().timeUs;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const RecordedFrame& frame : frames) {
+        const double offsetUs = static_cast<double>(frame.timeUs - firstUs) / speedFactor;
+        deliver(nullptr, frame.message, baseUs + static_cast<std::uint64_t>(offsetUs));
+    }
+}
+
+TPCANStatus VirtualCANBus::transmit(const VirtualCANNode* sender, const TPCANMsgFD& message) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_config.writeErrorProbability > 0.0 &&
+        std::uniform_real_distribution<double>(0.0, 1.0)(m_random) < m_config.writeErrorProbability) {
+        return m_config.writeErrorStatus;
+    }
+    const std::uint64_t sendUs = now();
+    if (m_recording) {
+        m_recorded.push_back(RecordedFrame{ sendUs, message });
+    }
+    deliver(sender, message, sendUs);
+    return PCAN_ERROR_OK;
+}
+
+// Called with m_mutex held
+void VirtualCANBus::deliver(const VirtualCANNode* sender, const TPCANMsgFD& message, std::uint64_t sendTimeUs) {
+    if (m_config.dropProbability > 0.0 &&
+        std::uniform_real_distribution<double>(0.0, 1.0)(m_random) < m_config.dropProbability) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    std::uint64_t deliveryUs = sendTimeUs + m_config.latencyUs;
+    if (m_config.jitterUs > 0) {
+        deliveryUs += std::uniform_int_distribution<std::uint32_t>(0, m_config.jitterUs)(m_random);
+    }
+    for (VirtualCANNode* node : m_nodes) {
+        if (node != sender) {
+            node->enqueue(message, deliveryUs, m_config.receiveQueueCapacity);
+        }
+    }
+    m_delivered.fetch_add(1, std::memory_order_relaxed);
+}
+
+void VirtualCANBus::attach(VirtualCANNode* node) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_nodes.push_back(node);
+}
+
+void VirtualCANBus::detach(VirtualCANNode* node) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_nodes.erase(std::remove(m_nodes.begin(), m_nodes.end(), node), m_nodes.end());
+}
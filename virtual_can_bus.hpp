@@ -0,0 +1,84 @@
+#ifndef VIRTUAL_CAN_BUS_HPP
+#define VIRTUAL_CAN_BUS_HPP
+
+#include "can_transport.hpp"
+#include "PCANBasic.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <vector>
+
+class VirtualCANNode;
+
+struct VirtualBusConfig {
+    std::uint32_t latencyUs = 0;            // Fixed delay between write and delivery
+    std::uint32_t jitterUs = 0;             // Extra uniform delay in [0, jitterUs]
+    double dropProbability = 0.0;           // Chance a frame is lost for every receiver
+    double writeErrorProbability = 0.0;     // Chance a write is rejected with writeErrorStatus
+    TPCANStatus writeErrorStatus = PCAN_ERROR_BUSHEAVY;
+    std::uint64_t seed = 1;                 // Same seed and same call sequence give the same run
+    std::size_t receiveQueueCapacity = 32768; // Per node; overflow is reported as PCAN_ERROR_QOVERRUN
+};
+
+// A frame seen on the bus, used for recording and replay
+struct RecordedFrame {
+    std::uint64_t timeUs;  // Bus time at which the frame was written
+    TPCANMsgFD message;    // Classic frames are stored with MSGTYPE without PCAN_MESSAGE_FD
+};
+
+// Deterministic in-process CAN bus for running the acquisition pipeline
+// without a PEAK adapter. Every node created with createNode() receives the
+// frames written by all other nodes after the configured latency and jitter.
+// Frames stay in order per receiver, as on a real bus.
+//
+// By default the bus runs on the host monotonic clock. With a manual clock,
+// time only moves through advanceTime(), so a test controls exactly when
+// frames become readable.
+//
+// Create the bus with std::make_shared; nodes keep it alive.
+class VirtualCANBus : public std::enable_shared_from_this<VirtualCANBus> {
+public:
+    explicit VirtualCANBus(VirtualBusConfig config = VirtualBusConfig());
+
+    std::unique_ptr<CANTransport> createNode();
+
+    void setManualClock(bool manual);
+    void advanceTime(std::uint64_t deltaUs);
+    std::uint64_t now() const;
+
+    void startRecording();
+    std::vector<RecordedFrame> stopRecording();
+
+    // Re-injects recorded traffic as if sent by a node outside the bus. Frame
+    // times are taken relative to the first frame and scaled by 1/speedFactor.
+    void replay(const std::vector<RecordedFrame>& frames, double speedFactor = 1.0);
+
+    unsigned long long deliveredFrameCount() const { return m_delivered.load(std::memory_order_relaxed); }
+    unsigned long long droppedFrameCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    friend class VirtualCANNode;
+
+    TPCANStatus transmit(const VirtualCANNode* sender, const TPCANMsgFD& message);
+    void deliver(const VirtualCANNode* sender, const TPCANMsgFD& message, std::uint64_t sendTimeUs);
+    void attach(VirtualCANNode* node);
+    void detach(VirtualCANNode* node);
+
+    VirtualBusConfig m_config;
+    std::atomic<std::uint64_t> m_startUs;  // Host time of bus time 0; moves when the manual clock is switched off
+    std::atomic<bool> m_manualClock{false};
+    std::atomic<std::uint64_t> m_manualTimeUs{0};
+
+    std::mutex m_mutex;                  // Guards the node list, RNG and recording
+    std::vector<VirtualCANNode*> m_nodes;
+    std::mt19937_64 m_random;
+    bool m_recording = false;
+    std::vector<RecordedFrame> m_recorded;
+
+    std::atomic<unsigned long long> m_delivered{0};
+    std::atomic<unsigned long long> m_dropped{0};
+};
+
+#endif // VIRTUAL_CAN_BUS_HPP
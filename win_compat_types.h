@@ -0,0 +1,28 @@
+//  win_compat_types.h
+//
+//  Windows base types used by PCANBasic.h, for builds without <windows.h>
+//  (virtual bus and SocketCAN backends on Linux). The PCAN-Basic functions
+//  themselves are only available on Windows.
+//
+#ifndef WIN_COMPAT_TYPES_H
+#define WIN_COMPAT_TYPES_H
+
+#include <stdint.h>
+
+typedef uint8_t   BYTE;
+typedef uint16_t  WORD;
+typedef uint32_t  DWORD;
+typedef uint32_t  UINT32;
+typedef uint64_t  UINT64;
+typedef char*     LPSTR;
+typedef void*     HANDLE;
+
+#ifndef __stdcall
+#define __stdcall
+#endif
+
+#ifndef __T
+#define __T(x) x
+#endif
+
+#endif // WIN_COMPAT_TYPES_H